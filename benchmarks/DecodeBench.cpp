@@ -0,0 +1,64 @@
+// Microbenchmark of decoding instruction words.
+//
+// "Decoder::decode" builds Instruction objects as the decode cache does on a
+// miss, "decodeOpcode" is the table lookup alone plus DecodedInst.
+#include "DecodedInst.h"
+#include "Decoder.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+const unsigned NUM_WORDS = 1 << 16;
+const unsigned NUM_ROUNDS = 64;
+
+/// random operands and immediates on top of every known encoding.
+std::vector<Word> makeWords() {
+  std::mt19937 Rand(42);
+  std::vector<Word> Words;
+  Words.reserve(NUM_WORDS);
+  for (unsigned i = 0; i < NUM_WORDS; ++i) {
+    const OpcodeInfo &Info = OpcodeInfos[Rand() % NUM_OPCODES];
+    Words.push_back(Info.Match | (Rand() & ~Info.Mask));
+  }
+  return Words;
+}
+
+template <typename F> double run(const std::vector<Word> &Words, F Decode) {
+  unsigned Sink = 0;
+  auto Begin = std::chrono::steady_clock::now();
+  for (unsigned R = 0; R < NUM_ROUNDS; ++R)
+    for (Word W : Words)
+      Sink += Decode(W);
+  auto End = std::chrono::steady_clock::now();
+  volatile unsigned Keep = Sink;
+  (void)Keep;
+  double Sec = std::chrono::duration<double>(End - Begin).count();
+  // instructions per second
+  return (double)NUM_ROUNDS * Words.size() / Sec;
+}
+
+} // namespace
+
+int main() {
+  std::vector<Word> Words = makeWords();
+  Decoder Dec;
+
+  double Objects = run(Words, [&](Word W) {
+    auto Inst = Dec.decode(W);
+    return static_cast<unsigned>(Inst->getOpcode());
+  });
+  double Table = run(Words, [](Word W) {
+    DecodedInst DI = makeDecodedInst(decodeOpcode(W), W);
+    return static_cast<unsigned>(DI.Op) + DI.Imm;
+  });
+
+  std::cout << std::fixed << std::setprecision(1)
+            << "Decoder::decode: " << std::setw(8) << Objects / 1e6
+            << " M insts/s | decodeOpcode: " << std::setw(8) << Table / 1e6
+            << " M insts/s\n";
+  return 0;
+}
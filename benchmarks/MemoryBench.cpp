@@ -0,0 +1,70 @@
+// Microbenchmark of the fetch + load path of Memory.
+//
+// "byte-wise" reproduces the previous implementation, which composed every
+// word from 4 byte accesses with their own bounds checks, "read<T>" is the
+// aligned fast path.
+#include "Memory.h"
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+const Address DRAM_BASE = 0x0000;
+const Address DRAM_SIZE = 1 << 28;
+const Address TEXT_SIZE = 1 << 12;
+const Address DATA_BASE = 1 << 20;
+const Address DATA_SIZE = 1 << 16;
+const unsigned long long NUM_FETCHES = 1 << 24;
+
+Word readWordByteWise(Memory &Mem, Address Ad) {
+  return Mem.readByte(Ad) + (Mem.readByte(Ad + 1) << 8) +
+         (Mem.readByte(Ad + 2) << 16) + (Mem.readByte(Ad + 3) << 24);
+}
+
+Word readWordFast(Memory &Mem, Address Ad) { return Mem.read<Word>(Ad); }
+
+/// one load on every 4 fetches, which is roughly the ratio of dhrystone.
+double run(Memory &Mem, const std::function<Word(Memory &, Address)> &Read) {
+  Word Sink = 0;
+  Address PC = DRAM_BASE, DataAd = DATA_BASE;
+  auto Begin = std::chrono::steady_clock::now();
+  for (unsigned long long i = 0; i < NUM_FETCHES; ++i) {
+    Sink ^= Read(Mem, PC);
+    PC = DRAM_BASE + ((PC + 4) & (TEXT_SIZE - 1));
+    if ((i & 3) == 0) {
+      Sink ^= Read(Mem, DataAd);
+      DataAd = DATA_BASE + ((DataAd + 12) & (DATA_SIZE - 4));
+    }
+  }
+  auto End = std::chrono::steady_clock::now();
+  volatile Word Keep = Sink;
+  (void)Keep;
+  double Sec = std::chrono::duration<double>(End - Begin).count();
+  // accesses per second
+  return (NUM_FETCHES + NUM_FETCHES / 4) / Sec;
+}
+
+} // namespace
+
+int main() {
+  for (MemoryKind Kind : {MemoryKind::Flat, MemoryKind::Paged}) {
+    Memory Mem(DRAM_SIZE, DRAM_BASE, Kind);
+    for (Address Ad = 0; Ad < TEXT_SIZE; Ad += 4)
+      Mem.writeWord(DRAM_BASE + Ad, 0x00000013 | (Ad << 20));
+    for (Address Ad = 0; Ad < DATA_SIZE; Ad += 4)
+      Mem.writeWord(DATA_BASE + Ad, Ad);
+
+    std::string KindStr = Kind == MemoryKind::Flat ? "flat" : "paged";
+    double Before = run(Mem, readWordByteWise);
+    double After = run(Mem, readWordFast);
+    std::cout << std::fixed << std::setprecision(1) << std::setw(6) << KindStr
+              << " | byte-wise: " << std::setw(8) << Before / 1e6
+              << " M accesses/s | read<T>: " << std::setw(8) << After / 1e6
+              << " M accesses/s | speedup: " << std::setprecision(2)
+              << After / Before << "x\n";
+  }
+  return 0;
+}
@@ -0,0 +1,57 @@
+// Microbenchmark of RIPSimulator::proceedNStage on a hot loop.
+//
+// Global operator new is replaced to count heap allocations, a steady-state
+// cycle is expected to make none.
+#include "RIPSimulator/RIPSimulator.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+namespace {
+
+unsigned long long NumAllocs = 0;
+
+const unsigned WARMUP_CYCLES = 1000;
+const unsigned NUM_CYCLES = 1 << 22;
+
+const Word LOOP[] = {
+    0x001002b7, // lui  x5, 0x100
+    0x00130313, // addi x6, x6, 1
+    0xfff28293, // addi x5, x5, -1
+    0xfe029ce3, // bne  x5, x0, -8
+    0x00100073, // ebreak
+};
+
+} // namespace
+
+void *operator new(std::size_t Size) {
+  ++NumAllocs;
+  if (void *P = std::malloc(Size ? Size : 1))
+    return P;
+  throw std::bad_alloc();
+}
+void operator delete(void *P) noexcept { std::free(P); }
+void operator delete(void *P, std::size_t) noexcept { std::free(P); }
+
+int main() {
+  std::stringstream ss;
+  ss.write(reinterpret_cast<const char *>(LOOP), sizeof(LOOP));
+  RIPSimulator RSim(ss, nullptr, 1 << 16, nullptr);
+
+  RSim.proceedNStage(WARMUP_CYCLES);
+  unsigned long long AllocsBefore = NumAllocs;
+  auto Begin = std::chrono::steady_clock::now();
+  RSim.proceedNStage(NUM_CYCLES);
+  auto End = std::chrono::steady_clock::now();
+  unsigned long long Allocs = NumAllocs - AllocsBefore;
+
+  double Sec = std::chrono::duration<double>(End - Begin).count();
+  std::cout << std::fixed << std::setprecision(1)
+            << "pipeline | " << std::setw(8) << NUM_CYCLES / Sec / 1e6
+            << " M cycles/s | allocations/cycle: " << std::setprecision(4)
+            << (double)Allocs / NUM_CYCLES << "\n";
+  return 0;
+}
@@ -76,3 +76,78 @@ TEST(DhrystoneTest, DhryStoneBareMetalExtended) {
   const Address PC = Sim.getPC();
   EXPECT_EQ(PC, 0x108) << "PC unmatched!\n";
 }
+
+// The other engines must end in exactly the same state as run().
+using RunFn = void (Simulator::*)(std::optional<Address>,
+                                  std::optional<Address>);
+void expectSameAsRun(const std::string &FileName, RunFn Run,
+                     Address ExpectedPC) {
+  auto RunFiles = std::ifstream(FileName);
+  Simulator RunSim(RunFiles, /*DRAMSize = */ 1LL << 28,
+                   /* DRAMBase = */ 0x0000,
+                   /* SPIvalue = */ 1LL << 25);
+  RunSim.run();
+  auto Files = std::ifstream(FileName);
+  Simulator Sim(Files, /*DRAMSize = */ 1LL << 28,
+                /* DRAMBase = */ 0x0000,
+                /* SPIvalue = */ 1LL << 25);
+  (Sim.*Run)(std::nullopt, std::nullopt);
+  EXPECT_EQ(Sim.getPC(), ExpectedPC) << "PC unmatched!\n";
+  for (unsigned i = 0; i < RegNum; ++i)
+    EXPECT_EQ(Sim.getGPRegs()[i], RunSim.getGPRegs()[i]) << "x" << i;
+  EXPECT_EQ(Sim.getCSRs()[CYCLE], RunSim.getCSRs()[CYCLE]);
+  EXPECT_EQ(Sim.getStats().getInstCounts(), RunSim.getStats().getInstCounts());
+}
+
+TEST(DhrystoneTest, DhryStoneThreaded) {
+  expectSameAsRun(findTest("dhry_.*\\.bin"), &Simulator::runThreaded,
+                  0x0490);
+}
+
+TEST(DhrystoneTest, DhryStoneThreadedFusion) {
+  auto Files = std::ifstream(findTest("dhry_.*\\.bin"));
+  Simulator Sim(Files, /*DRAMSize = */ 1LL << 28, /* DRAMBase = */ 0x0000,
+                /* SPIvalue = */ 1LL << 25);
+  Sim.runThreaded();
+  const auto &Fusions = Sim.getStats().getFusionCounts();
+  EXPECT_TRUE(Fusions.count("lui+addi"));
+  EXPECT_TRUE(Fusions.count("auipc+jalr") || Fusions.count("auipc+addi"));
+}
+
+TEST(DhrystoneTest, DhryStoneBareMetalThreaded) {
+  expectSameAsRun(findTest("dhry-baremetal_.*\\.bin"),
+                  &Simulator::runThreaded, 0x0084);
+}
+
+TEST(DhrystoneTest, DhryStoneExtendedThreaded) {
+  expectSameAsRun(findTest("dhry_.*\\.bin\\.rip"), &Simulator::runThreaded,
+                  0x0540);
+}
+
+TEST(DhrystoneTest, DhryStoneBlocks) {
+  expectSameAsRun(findTest("dhry_.*\\.bin"), &Simulator::runBlocks, 0x0490);
+}
+
+TEST(DhrystoneTest, DhryStoneBareMetalBlocks) {
+  expectSameAsRun(findTest("dhry-baremetal_.*\\.bin"), &Simulator::runBlocks,
+                  0x0084);
+}
+
+TEST(DhrystoneTest, DhryStoneExtendedBlocks) {
+  expectSameAsRun(findTest("dhry_.*\\.bin\\.rip"), &Simulator::runBlocks,
+                  0x0540);
+}
+
+TEST(DhrystoneTest, DhryStoneJIT) {
+  expectSameAsRun(findTest("dhry_.*\\.bin"), &Simulator::runJIT, 0x0490);
+}
+
+TEST(DhrystoneTest, DhryStoneBareMetalJIT) {
+  expectSameAsRun(findTest("dhry-baremetal_.*\\.bin"), &Simulator::runJIT,
+                  0x0084);
+}
+
+TEST(DhrystoneTest, DhryStoneExtendedJIT) {
+  expectSameAsRun(findTest("dhry_.*\\.bin\\.rip"), &Simulator::runJIT,
+                  0x0540);
+}
@@ -0,0 +1,135 @@
+#ifndef BLOCKCACHE_H
+#define BLOCKCACHE_H
+
+#include "CommonTypes.h"
+#include "DecodedInst.h"
+#include "Memory.h"
+#include <bitset>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+/// Straight-line instructions which are entered only from EntryPC.
+///
+/// A block ends with a branch, a jump or a system instruction (csr*, ecall,
+/// fence.i, ...), before an undecodable word, or on a page boundary.
+struct BasicBlock {
+  /// An edge to a successor, followed without looking up the cache. The
+  /// edge is valid only if Epoch matches the one of the cache.
+  struct Link {
+    Address PC;
+    BasicBlock *Block;
+    std::uint64_t Epoch;
+  };
+
+  Address EntryPC;
+  std::vector<DecodedInst> Insts;
+  /// [0]: fall through, [1]: taken branch or jal target.
+  Link Succs[2];
+  std::uint64_t ExecCount = 0;
+  /// cleared when the code of the block is overwritten.
+  bool Valid = true;
+  /// host code compiled from the block, owned by the compiler.
+  void *HostCode = nullptr;
+};
+
+/// Basic blocks keyed by entry PC, with direct links between blocks.
+///
+/// Entries are allocated per page of Memory like DecodeCache. A store into
+/// a page holding blocks retires the overlapping blocks, and fence.i retires
+/// everything. Retired blocks stay alive until collect(), so that a block
+/// can overwrite its own code while it runs.
+class BlockCache {
+public:
+  /// blocks are split at this length.
+  static constexpr unsigned MaxBlockInsts = 64;
+
+private:
+  static constexpr Address EntriesPerPage = Memory::PageSize / sizeof(Word);
+  using BlockPtr = std::unique_ptr<BasicBlock>;
+
+  struct BlockPage {
+    BlockPtr Blocks[EntriesPerPage];
+    /// words which may be in a block, stores to others are ignored.
+    std::bitset<EntriesPerPage> Covered;
+  };
+
+  Memory &Mem;
+  std::vector<std::unique_ptr<BlockPage>> Pages;
+  std::vector<BlockPtr> Retired;
+  /// bumped on every retirement, which breaks all links at once.
+  std::uint64_t Epoch = 0;
+  /// blocks end before this address, so the caller can stop on it.
+  std::optional<Address> StopAddress;
+  /// execution counts of the retired blocks.
+  std::map<Address, std::uint64_t> RetiredCounts;
+
+  std::uint64_t Hits = 0;
+  std::uint64_t Misses = 0;
+  std::uint64_t Chained = 0;
+
+  BasicBlock *translate(Address PC);
+  void retire(BlockPtr &Block);
+
+public:
+  BlockCache(const BlockCache &) = delete;
+  BlockCache &operator=(const BlockCache &) = delete;
+
+  BlockCache(Memory &Mem);
+
+  /// returns the block starting at PC, nullptr if PC can't be decoded.
+  BasicBlock *lookup(Address PC) {
+    Address Off = PC - Mem.getDRAMBase();
+    if (Off < Mem.getDRAMSize() && (Off & (sizeof(Word) - 1)) == 0) {
+      if (const auto &Page = Pages[Off >> Memory::PageBits]) {
+        if (const auto &Block =
+                Page->Blocks[(Off & (Memory::PageSize - 1)) / sizeof(Word)]) {
+          ++Hits;
+          return Block.get();
+        }
+      }
+    }
+    return translate(PC);
+  }
+
+  /// returns the block on PC which follows From, by its link if possible.
+  BasicBlock *next(BasicBlock *From, Address PC) {
+    for (auto &L : From->Succs) {
+      if (L.PC != PC)
+        continue;
+      if (L.Block && L.Epoch == Epoch) {
+        ++Chained;
+        return L.Block;
+      }
+      L.Block = lookup(PC);
+      L.Epoch = Epoch;
+      return L.Block;
+    }
+    return lookup(PC);
+  }
+
+  /// free the retired blocks, no block may be running.
+  void collect() {
+    if (!Retired.empty())
+      Retired.clear();
+  }
+
+  /// set the address blocks stop before, which drops all blocks on change.
+  void setStopAddress(std::optional<Address> Ad);
+
+  /// retire blocks overlapping with [Ad, Ad + Size).
+  void invalidate(Address Ad, unsigned Size);
+  /// retire all blocks, used for fence.i.
+  void flush();
+
+  /// execution counts by entry PC, including retired blocks.
+  std::map<Address, std::uint64_t> getBlockCounts() const;
+
+  std::uint64_t getHits() const { return Hits; }
+  std::uint64_t getMisses() const { return Misses; }
+  /// the number of transitions done by links.
+  std::uint64_t getChained() const { return Chained; }
+};
+#endif
@@ -0,0 +1,64 @@
+#ifndef DECODECACHE_H
+#define DECODECACHE_H
+
+#include "CommonTypes.h"
+#include "Decoder.h"
+#include "Instructions.h"
+#include "Memory.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// Decoded instructions keyed by PC, so that each static instruction is
+/// decoded once.
+///
+/// Entries are allocated per page of Memory on the first fetch from it. A
+/// store into such a page is reported by Memory and drops the overwritten
+/// entries, fence.i drops everything. Instructions are shared with the
+/// caller, an invalidated entry stays alive while it is in flight.
+class DecodeCache {
+public:
+  using InstPtr = std::shared_ptr<Instruction>;
+
+private:
+  static constexpr Address EntriesPerPage = Memory::PageSize / sizeof(Word);
+
+  Memory &Mem;
+  Decoder &Dec;
+  std::vector<std::unique_ptr<InstPtr[]>> Pages;
+
+  std::uint64_t Hits = 0;
+  std::uint64_t Misses = 0;
+
+  InstPtr fill(Address PC);
+
+public:
+  DecodeCache(const DecodeCache &) = delete;
+  DecodeCache &operator=(const DecodeCache &) = delete;
+
+  DecodeCache(Memory &Mem, Decoder &Dec);
+
+  /// returns the instruction at PC, nullptr if it can't be decoded.
+  InstPtr fetch(Address PC) {
+    Address Off = PC - Mem.getDRAMBase();
+    if (Off < Mem.getDRAMSize() && (Off & (sizeof(Word) - 1)) == 0) {
+      if (const auto &Page = Pages[Off >> Memory::PageBits]) {
+        if (const auto &Inst =
+                Page[(Off & (Memory::PageSize - 1)) / sizeof(Word)]) {
+          ++Hits;
+          return Inst;
+        }
+      }
+    }
+    return fill(PC);
+  }
+
+  /// drop entries overlapping with [Ad, Ad + Size).
+  void invalidate(Address Ad, unsigned Size);
+  /// drop all entries, used for fence.i.
+  void flush();
+
+  std::uint64_t getHits() const { return Hits; }
+  std::uint64_t getMisses() const { return Misses; }
+};
+#endif
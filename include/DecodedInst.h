@@ -0,0 +1,77 @@
+#ifndef DECODEDINST_H
+#define DECODEDINST_H
+
+#include "CommonTypes.h"
+#include "Opcode.h"
+#include <cstdint>
+#include <type_traits>
+
+/// Trivially copyable form of an instruction which simulators consume.
+///
+/// Operand fields are extracted once on decoding, and Imm is already sign
+/// extended by the format:
+///   I, S: imm[11:0], B: imm[12:1], J: imm[20:1] (so lowest bit is 0),
+///   U: imm[31:12] without shifting, R: 0.
+struct DecodedInst {
+  Word Val;
+  std::int32_t Imm;
+  Opcode Op;
+  std::uint8_t Rd, Rs1, Rs2;
+  std::uint8_t Flags; // OpFlags of Op
+
+  bool hasRd() const { return Flags & OpFlags::HasRd; }
+  bool hasRs1() const { return Flags & OpFlags::HasRs1; }
+  bool hasRs2() const { return Flags & OpFlags::HasRs2; }
+  bool isBranch() const { return Flags & OpFlags::Branch; }
+  bool isLoad() const { return Flags & OpFlags::Load; }
+  bool isStore() const { return Flags & OpFlags::Store; }
+  bool isCSR() const { return Flags & OpFlags::CSR; }
+  bool isCSRImm() const { return Flags & OpFlags::CSRImm; }
+  InstFormat getFormat() const { return ::getFormat(Op); }
+  /// CSR address of csr* instructions, which is the raw I-type immediate.
+  unsigned getCSRAddr() const { return Val >> 20; }
+};
+
+static_assert(std::is_trivially_copyable_v<DecodedInst>);
+static_assert(sizeof(DecodedInst) <= 16);
+
+inline std::int32_t decodeImm(InstFormat Format, Word Val) {
+  // arithmetic right shift of the signed value does sign extension.
+  std::int32_t SVal = static_cast<std::int32_t>(Val);
+  switch (Format) {
+  case InstFormat::I:
+    return SVal >> 20;
+  case InstFormat::S:
+    return ((SVal >> 20) & ~0x1f) | ((Val >> 7) & 0x1f);
+  case InstFormat::B:
+    return ((SVal >> 19) & ~0xfff) | ((Val & 0x80) << 4) |
+           ((Val >> 20) & 0x7e0) | ((Val >> 7) & 0x1e);
+  case InstFormat::J:
+    return ((SVal >> 11) & ~0xfffff) | (Val & 0xff000) |
+           ((Val >> 9) & 0x800) | ((Val >> 20) & 0x7fe);
+  case InstFormat::U:
+    return SVal >> 12;
+  case InstFormat::R:
+    return 0;
+  }
+  return 0;
+}
+
+inline DecodedInst makeDecodedInst(Opcode Op, Word Val) {
+  DecodedInst DI;
+  DI.Val = Val;
+  DI.Op = Op;
+  DI.Rd = (Val >> 7) & 0x1f;
+  DI.Rs1 = (Val >> 15) & 0x1f;
+  DI.Rs2 = (Val >> 20) & 0x1f;
+  if (Op == Opcode::INVALID) {
+    DI.Imm = 0;
+    DI.Flags = 0;
+    return DI;
+  }
+  DI.Imm = decodeImm(::getFormat(Op), Val);
+  DI.Flags = getOpcodeInfo(Op).Flags;
+  return DI;
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef FUSION_H
+#define FUSION_H
+
+#include "DecodedInst.h"
+#include "Opcode.h"
+#include <cstdint>
+
+/// Pairs of adjacent instructions which simulators may execute as one
+/// superinstruction. A fused pair still retires two instructions.
+///
+/// To add a pair, add a kind here, its rule to FusionRules, and the fused
+/// handler to the simulators using it (see Simulator::runThreaded()).
+enum class FusionKind : std::uint8_t {
+  LUI_ADDI,   // lui rd, hi; addi rd, rd, lo
+  AUIPC_ADDI, // auipc rd, hi; addi rd, rd, lo
+  AUIPC_JALR, // auipc rs, hi; jalr rd, lo(rs)
+  SLT_BRANCH, // slt[i][u] rd, ...; beq/bne rd, x0, offset
+
+  NONE,
+};
+
+constexpr unsigned NUM_FUSIONS = static_cast<unsigned>(FusionKind::NONE);
+
+namespace fusion {
+
+inline bool isLuiAddi(const DecodedInst &First, const DecodedInst &Second) {
+  return First.Op == Opcode::LUI && Second.Op == Opcode::ADDI &&
+         First.Rd != 0 && Second.Rd == First.Rd && Second.Rs1 == First.Rd;
+}
+
+inline bool isAuipcAddi(const DecodedInst &First, const DecodedInst &Second) {
+  return First.Op == Opcode::AUIPC && Second.Op == Opcode::ADDI &&
+         First.Rd != 0 && Second.Rd == First.Rd && Second.Rs1 == First.Rd;
+}
+
+inline bool isAuipcJalr(const DecodedInst &First, const DecodedInst &Second) {
+  return First.Op == Opcode::AUIPC && Second.Op == Opcode::JALR &&
+         First.Rd != 0 && Second.Rs1 == First.Rd;
+}
+
+inline bool isSltBranch(const DecodedInst &First, const DecodedInst &Second) {
+  bool IsSlt = First.Op == Opcode::SLT || First.Op == Opcode::SLTU ||
+               First.Op == Opcode::SLTI || First.Op == Opcode::SLTIU;
+  bool IsBeqz = Second.Op == Opcode::BEQ || Second.Op == Opcode::BNE;
+  return IsSlt && IsBeqz && First.Rd != 0 &&
+         ((Second.Rs1 == First.Rd && Second.Rs2 == 0) ||
+          (Second.Rs1 == 0 && Second.Rs2 == First.Rd));
+}
+
+} // namespace fusion
+
+struct FusionRule {
+  const char *Name;
+  bool (*Match)(const DecodedInst &First, const DecodedInst &Second);
+};
+
+/// indexed by FusionKind, the first matching rule wins.
+constexpr FusionRule FusionRules[NUM_FUSIONS] = {
+    {"lui+addi", fusion::isLuiAddi},
+    {"auipc+addi", fusion::isAuipcAddi},
+    {"auipc+jalr", fusion::isAuipcJalr},
+    {"slt+branch", fusion::isSltBranch},
+};
+
+/// returns the kind of the pair First; Second, NONE if it isn't fused.
+inline FusionKind matchFusion(const DecodedInst &First,
+                              const DecodedInst &Second) {
+  for (unsigned i = 0; i < NUM_FUSIONS; ++i)
+    if (FusionRules[i].Match(First, Second))
+      return static_cast<FusionKind>(i);
+  return FusionKind::NONE;
+}
+
+inline const char *getFusionName(FusionKind Kind) {
+  return FusionRules[static_cast<unsigned>(Kind)].Name;
+}
+
+#endif
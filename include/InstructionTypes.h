@@ -1,8 +1,10 @@
 #ifndef INSTRUCTION_TYPES_H
 #define INSTRUCTION_TYPES_H
 
+#include "Opcode.h"
 #include <bitset>
 #include <map>
+#include <string>
 
 // classes to assemble
 class ISBType {
@@ -11,64 +13,36 @@ private:
   const std::string mnemonic;
   const std::bitset<3> funct3;
   const std::bitset<7> opcode;
+  const Opcode Op;
 
 public:
   ISBType(const std::string &mnemonic, const unsigned funct3,
-          const unsigned opcode)
-      : mnemonic(mnemonic), funct3(funct3), opcode(opcode) {}
+          const unsigned opcode, Opcode Op)
+      : mnemonic(mnemonic), funct3(funct3), opcode(opcode), Op(Op) {}
   const std::string &getMnemo() const { return mnemonic; }
+  Opcode getOp() const { return Op; }
   const std::bitset<3> &getFunct3() const { return funct3; }
   const std::bitset<7> &getOpcode() const { return opcode; }
 };
 
-const std::map<const std::string, const ISBType> ITypeKinds = {
-    {"addi",   {"addi",   0b000, 0b0010011}},
-    {"slti",   {"slti",   0b010, 0b0010011}},
-    {"sltiu",  {"sltiu",  0b011, 0b0010011}},
-    {"xori",   {"xori",   0b100, 0b0010011}},
-    {"ori",    {"ori",    0b110, 0b0010011}},
-    {"andi",   {"andi",   0b111, 0b0010011}},
-    {"jalr",   {"jalr",   0b000, 0b1100111}},
-    {"lb",     {"lb",     0b000, 0b0000011}},
-    {"lh",     {"lh",     0b001, 0b0000011}},
-    {"lw",     {"lw",     0b010, 0b0000011}},
-    {"lbu",    {"lbu",    0b100, 0b0000011}},
-    {"lhu",    {"lhu",    0b101, 0b0000011}},
-    {"slli",   {"slli",   0b001, 0b0010011}},
-    {"srli",   {"srli",   0b101, 0b0010011}},
-    {"srai",   {"srai",   0b101, 0b0010011}},
-    // {"fence", {"fence", 0b000, 0b0001111}},
-    // {"fence.i", {"fence.i", 0b001, 0b0001111}},
-    // csr
-    {"csrrw",  {"csrrw",  0b001, 0b1110011}}, // Read/Write
-    {"csrrs",  {"csrrs",  0b010, 0b1110011}}, // Read and Set bits
-    {"csrrc",  {"csrrc",  0b011, 0b1110011}}, // Read and Clear bits
-    {"csrrwi", {"csrrwi", 0b101, 0b1110011}},
-    {"csrrsi", {"csrrsi", 0b110, 0b1110011}},
-    {"csrrci", {"csrrci", 0b111, 0b1110011}},
-    {"ecall",  {"ecall",  0b000, 0b1110011}},
-    {"ebreak", {"ebreak", 0b000, 0b1110011}},
-    {"uret",   {"uret",   0b000, 0b1110011}},
-    {"sret",   {"sret",   0b000, 0b1110011}},
-    {"mret",   {"mret",   0b000, 0b1110011}},
-    {"ext",    {"ext",    0b000, 0b0001011}}, // extended
-    {"extx",   {"extx",   0b000, 0b0001011}},
-};
+/// Kinds of Format (I, S or B) generated from OpcodeInfos.
+inline std::map<std::string, ISBType> makeISBTypeKinds(InstFormat Format) {
+  std::map<std::string, ISBType> Kinds;
+  for (unsigned i = 0; i < NUM_OPCODES; ++i) {
+    const OpcodeInfo &Info = OpcodeInfos[i];
+    if (Info.Format == Format)
+      Kinds.try_emplace(Info.Mnemo, Info.Mnemo, (Info.Match >> 12) & 0b111,
+                        Info.Match & 0x7f, static_cast<Opcode>(i));
+  }
+  return Kinds;
+}
 
-const std::map<std::string, ISBType> STypeKinds = {
-    {"sb", {"sb", 0b000, 0b0100011}},
-    {"sh", {"sh", 0b001, 0b0100011}},
-    {"sw", {"sw", 0b010, 0b0100011}},
-};
-
-const std::map<std::string, ISBType> BTypeKinds = {
-    {"beq", {"beq", 0b000, 0b1100011}}, // Branch EQual
-    {"bne", {"bne", 0b001, 0b1100011}},
-    {"blt", {"blt", 0b100, 0b1100011}}, // Branch Less Than
-    {"bge", {"bge", 0b101, 0b1100011}},
-    {"bltu", {"bltu", 0b110, 0b1100011}},
-    {"bgeu", {"bgeu", 0b111, 0b1100011}},
-};
+const std::map<std::string, ISBType> ITypeKinds =
+    makeISBTypeKinds(InstFormat::I);
+const std::map<std::string, ISBType> STypeKinds =
+    makeISBTypeKinds(InstFormat::S);
+const std::map<std::string, ISBType> BTypeKinds =
+    makeISBTypeKinds(InstFormat::B);
 
 class RType {
 private:
@@ -76,56 +50,63 @@ private:
   const std::bitset<7> funct7;
   const std::bitset<3> funct3;
   const std::bitset<7> opcode;
+  const Opcode Op;
 
 public:
   RType(const std::string &mnemonic, const unsigned funct7,
-        const unsigned funct3, const unsigned opcode)
-      : mnemonic(mnemonic), funct7(funct7), funct3(funct3), opcode(opcode) {}
+        const unsigned funct3, const unsigned opcode, Opcode Op)
+      : mnemonic(mnemonic), funct7(funct7), funct3(funct3), opcode(opcode),
+        Op(Op) {}
   const std::string &getMnemo() const { return mnemonic; }
+  Opcode getOp() const { return Op; }
   const std::bitset<7> &getFunct7() const { return funct7; }
   const std::bitset<3> &getFunct3() const { return funct3; }
   const std::bitset<7> &getOpcode() const { return opcode; }
 };
-const std::map<std::string, RType> RTypeKinds = {
-    {"add",    {"add",     0b0000000, 0b000, 0b0110011}},
-    {"sub",    {"sub",     0b0100000, 0b000, 0b0110011}},
-    {"sll",    {"sll",     0b0000000, 0b001, 0b0110011}},
-    {"slt",    {"slt",     0b0000000, 0b010, 0b0110011}},
-    {"sltu",   {"sltu",    0b0000000, 0b011, 0b0110011}},
-    {"xor",    {"xor",     0b0000000, 0b100, 0b0110011}},
-    {"srl",    {"srl",     0b0000000, 0b101, 0b0110011}},
-    {"sra",    {"sra",     0b0100000, 0b101, 0b0110011}},
-    {"or",     {"or",      0b0000000, 0b110, 0b0110011}},
-    {"and",    {"and",     0b0000000, 0b111, 0b0110011}},
-    {"mul",    {"mul",     0b0000001, 0b000, 0b0110011}},
-    {"mulh",   {"mulh",    0b0000001, 0b001, 0b0110011}},
-    {"mulhsu", {"mulhsu",  0b0000001, 0b010, 0b0110011}},
-    {"mulhu",  {"mulhu",   0b0000001, 0b011, 0b0110011}},
-    {"div",    {"div",     0b0000001, 0b100, 0b0110011}},
-    {"divu",   {"divu",    0b0000001, 0b101, 0b0110011}},
-    {"rem",    {"rem",     0b0000001, 0b110, 0b0110011}},
-    {"remu",   {"remu",    0b0000001, 0b111, 0b0110011}},
-};
+
+inline std::map<std::string, RType> makeRTypeKinds() {
+  std::map<std::string, RType> Kinds;
+  for (unsigned i = 0; i < NUM_OPCODES; ++i) {
+    const OpcodeInfo &Info = OpcodeInfos[i];
+    if (Info.Format == InstFormat::R)
+      Kinds.try_emplace(Info.Mnemo, Info.Mnemo, Info.Match >> 25,
+                        (Info.Match >> 12) & 0b111, Info.Match & 0x7f,
+                        static_cast<Opcode>(i));
+  }
+  return Kinds;
+}
+
+const std::map<std::string, RType> RTypeKinds = makeRTypeKinds();
 
 class UJType {
 private:
   const std::string mnemonic;
   const std::bitset<7> opcode;
+  const Opcode Op;
 
 public:
-  UJType(const std::string &mnemonic, const unsigned opcode)
-      : mnemonic(mnemonic), opcode(opcode) {}
+  UJType(const std::string &mnemonic, const unsigned opcode, Opcode Op)
+      : mnemonic(mnemonic), opcode(opcode), Op(Op) {}
   const std::string &getMnemo() const { return mnemonic; }
+  Opcode getOp() const { return Op; }
   const std::bitset<7> &getOpcode() const { return opcode; }
 };
 
-const std::map<std::string, UJType> UTypeKinds = {
-    {"lui", {"lui", 0b0110111}},    // Load Upper Immediate
-    {"auipc", {"auipc", 0b0010111}} // Add Upper Immediate to PC
-};
+/// Kinds of Format (U or J) generated from OpcodeInfos.
+inline std::map<std::string, UJType> makeUJTypeKinds(InstFormat Format) {
+  std::map<std::string, UJType> Kinds;
+  for (unsigned i = 0; i < NUM_OPCODES; ++i) {
+    const OpcodeInfo &Info = OpcodeInfos[i];
+    if (Info.Format == Format)
+      Kinds.try_emplace(Info.Mnemo, Info.Mnemo, Info.Match & 0x7f,
+                        static_cast<Opcode>(i));
+  }
+  return Kinds;
+}
 
-const std::map<std::string, UJType> JTypeKinds = {
-    {"jal", {"jal", 0b1101111}} // Jump And Link
-};
+const std::map<std::string, UJType> UTypeKinds =
+    makeUJTypeKinds(InstFormat::U);
+const std::map<std::string, UJType> JTypeKinds =
+    makeUJTypeKinds(InstFormat::J);
 
 #endif
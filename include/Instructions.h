@@ -1,9 +1,11 @@
 #ifndef INSTRUCTIONS_H
 #define INSTRUCTIONS_H
 #include "CSR.h"
+#include "DecodedInst.h"
 #include "Exceptions.h"
 #include "InstructionTypes.h"
 #include "Memory.h"
+#include "Opcode.h"
 #include "Registers.h"
 #include <cassert>
 #include <iomanip>
@@ -48,16 +50,31 @@ static const std::optional<std::bitset<5>> findReg(const std::string &RegStr) {
 } // namespace
 class Instruction {
   unsigned Val;
+  Opcode Op;
+  DecodedInst Decoded;
+
+protected:
+  Instruction(Opcode Op)
+      : Val(0), Op(Op), Decoded(makeDecodedInst(Op, 0)) {
+    assert(Op != Opcode::INVALID && "unknown instruction");
+  }
 
 public:
-  void setVal(unsigned V) { Val = V; }
+  void setVal(unsigned V) {
+    Val = V;
+    Decoded = makeDecodedInst(Op, V);
+  }
+
+  /// Pre-extracted operands for simulators.
+  const DecodedInst &getDecoded() const { return Decoded; }
 
   // TODO: make this private.
   const unsigned getVal() { return Val; }
 
-  const inline bool hasRd() {
-    return !(STypeKinds.count(getMnemo()) || BTypeKinds.count(getMnemo()));
-  }
+  Opcode getOpcode() const { return Op; }
+  InstFormat getFormat() const { return ::getFormat(Op); }
+
+  const inline bool hasRd() { return hasFlag(Op, OpFlags::HasRd); }
 
   const inline unsigned getRd() {
     if (!hasRd())
@@ -65,9 +82,7 @@ public:
     return (Val & 0x00000f80) >> 7;
   }
 
-  const inline bool hasRs1() {
-    return !(UTypeKinds.count(getMnemo()) || JTypeKinds.count(getMnemo()));
-  }
+  const inline bool hasRs1() { return hasFlag(Op, OpFlags::HasRs1); }
 
   const inline unsigned getRs1() {
     if (!hasRs1())
@@ -75,10 +90,7 @@ public:
     return (Val & 0x000f8000) >> 15;
   }
 
-  const inline bool hasRs2() {
-    return !(ITypeKinds.count(getMnemo()) || UTypeKinds.count(getMnemo()) ||
-             JTypeKinds.count(getMnemo()));
-  }
+  const inline bool hasRs2() { return hasFlag(Op, OpFlags::HasRs2); }
 
   const inline unsigned getRs2() {
     if (!hasRs2())
@@ -87,33 +99,33 @@ public:
   }
 
   const inline unsigned getIImm() {
-    if (!ITypeKinds.count(getMnemo()))
+    if (getFormat() != InstFormat::I)
       assert(false && "This isn't expected to be called on not I-inst!");
     return (Val & 0xfff00000) >> 20;
   }
 
   const inline unsigned getSImm() {
-    if (!STypeKinds.count(getMnemo()))
+    if (getFormat() != InstFormat::S)
       assert(false && "This isn't expected to be called on not S-inst!");
     return (Val & 0xfe000000) >> 20 | ((Val >> 7) & 0x1f);
   }
 
   const inline unsigned getJImm() {
-    if (!JTypeKinds.count(getMnemo()))
+    if (getFormat() != InstFormat::J)
       assert(false && "This isn't expected to be called on not J-inst!");
     return ((Val & 0x80000000) >> 11) | (Val & 0xff000) | ((Val >> 9) & 0x800) |
            ((Val >> 20) & 0x7fe);
   }
 
   const inline unsigned getBImm() {
-    if (!BTypeKinds.count(getMnemo()))
+    if (getFormat() != InstFormat::B)
       assert(false && "This isn't expected to be called on not B-inst!");
     return (Val & 0x80000000) >> 19 | ((Val & 0x80) << 4) |
            ((Val >> 20) & 0x7e0) | ((Val >> 7) & 0x1e);
   }
 
   const inline unsigned getUImm() {
-    if (!UTypeKinds.count(getMnemo()))
+    if (getFormat() != InstFormat::U)
       assert(false && "This isn't expected to be called on not U-inst!");
     return (Val & 0xfffff000) >> 12;
   }
@@ -125,8 +137,6 @@ public:
   }
   virtual void pprint(std::ostream &) = 0;
   virtual void mprint(std::ostream &) = 0;
-  virtual std::optional<Exception> exec(Address &, GPRegisters &, Memory &,
-                                        CSRs &, ModeKind &) = 0;
   virtual ~Instruction() {}
 };
 
@@ -155,14 +165,12 @@ private:
 public:
   /// Encoding
   IInstruction(const ISBType &IT, const std::vector<std::string> &Toks)
-      : IT(IT) {
+      : Instruction(IT.getOp()), IT(IT) {
     Rd = *findReg(Toks[1]);
 
     // handle offset for loads
     if (Toks.size() == 3) {
-      assert((IT.getMnemo() == "lb" || IT.getMnemo() == "lh" ||
-              IT.getMnemo() == "lw" || IT.getMnemo() == "lbu" ||
-              IT.getMnemo() == "lhu") &&
+      assert(isLoad(getOpcode()) &&
              "invarid offset(reg) notation except loads");
       // op rd, offset(rs1)
       auto OffReg = parseOffsetReg(Toks[2]);
@@ -175,7 +183,7 @@ public:
     }
 
     // srai immediate
-    if (Toks[0] == "srai")
+    if (getOpcode() == Opcode::SRAI)
       Imm |= 1 << 10;
 
     setVal((Imm.to_ulong() << 20) | (Rs1.to_ulong() << 15) |
@@ -185,7 +193,7 @@ public:
 
   IInstruction(const ISBType &IT, const unsigned Rd, const unsigned Rs1,
                const unsigned Imm)
-      : IT(IT), Rd(Rd), Rs1(Rs1), Imm(Imm) {
+      : Instruction(IT.getOp()), IT(IT), Rd(Rd), Rs1(Rs1), Imm(Imm) {
     // FIXME: rename member as _XX?
     setVal((this->Imm.to_ulong() << 20) | (this->Rs1.to_ulong() << 15) |
            (IT.getFunct3().to_ulong() << 12) | (this->Rd.to_ulong() << 7) |
@@ -195,29 +203,26 @@ public:
   const std::string &getMnemo() override { return IT.getMnemo(); }
 
   void mprint(std::ostream &os) override {
-    if (IT.getMnemo() == "lb" || IT.getMnemo() == "lh" ||
-        IT.getMnemo() == "lw" || IT.getMnemo() == "lbu" ||
-        IT.getMnemo() == "lhu")
+    if (isLoad(getOpcode()))
       os << IT.getMnemo() << " " << ABI[Rd.to_ulong()] << " "
          << "(" << std::dec << signExtend(Imm) << ")" << ABI[Rs1.to_ulong()];
-    else if ((int)IT.getMnemo().rfind("csr") != -1 &&
-             (int)IT.getMnemo().rfind("i") == -1) {
+    else if (isCSR(getOpcode()) && !isCSRImm(getOpcode())) {
       CSRAddress CSRAddr = (unsigned)signExtend(Imm);
       os << IT.getMnemo() << " " << ABI[Rd.to_ulong()] << " "
          << " " << std::dec
          << (CSRNames.count(CSRAddr) ? CSRNames.find(CSRAddr)->second
                                      : std::to_string(CSRAddr))
          << " " << ABI[Rs1.to_ulong()];
-    } else if ((int)IT.getMnemo().rfind("csr") != -1 &&
-               (int)IT.getMnemo().rfind("i") != -1) {
+    } else if (isCSRImm(getOpcode())) {
       CSRAddress CSRAddr = (unsigned)signExtend(Imm);
       os << IT.getMnemo() << " " << ABI[Rd.to_ulong()] << " "
          << " " << std::dec
          << (CSRNames.count(CSRAddr) ? CSRNames.find(CSRAddr)->second
                                      : std::to_string(CSRAddr))
          << " " << Rs1.to_ulong();
-    } else if (IT.getMnemo() == "ecall" || IT.getMnemo() == "ebreak" ||
-               (int)IT.getMnemo().rfind("ret") != -1) {
+    } else if (getOpcode() == Opcode::ECALL || getOpcode() == Opcode::EBREAK ||
+               getOpcode() == Opcode::URET || getOpcode() == Opcode::SRET ||
+               getOpcode() == Opcode::MRET) {
       os << IT.getMnemo();
     } else
       os << IT.getMnemo() << " " << ABI[Rd.to_ulong()] << " "
@@ -225,9 +230,7 @@ public:
   }
 
   void pprint(std::ostream &os) override {
-    if (IT.getMnemo() == "lb" || IT.getMnemo() == "lh" ||
-        IT.getMnemo() == "lw" || IT.getMnemo() == "lbu" ||
-        IT.getMnemo() == "lhu")
+    if (isLoad(getOpcode()))
       os << IT.getMnemo() << " " << ABI[Rd.to_ulong()] << " "
          << "(" << std::dec << signExtend(Imm) << ")" << ABI[Rs1.to_ulong()];
     else
@@ -251,8 +254,6 @@ public:
     os << "(HEX LE)";
     os << "\n";
   }
-  std::optional<Exception> exec(Address &P, GPRegisters &GPRegs, Memory &M,
-                                CSRs &CSRs, ModeKind &Mode) override;
 };
 
 class RInstruction : public Instruction {
@@ -263,7 +264,8 @@ private:
 
 public:
   /// Encoding
-  RInstruction(const RType &RT, const std::vector<std::string> &Toks) : RT(RT) {
+  RInstruction(const RType &RT, const std::vector<std::string> &Toks)
+      : Instruction(RT.getOp()), RT(RT) {
     Rd = *findReg(Toks[1]);
     Rs1 = *findReg(Toks[2]);
     Rs2 = *findReg(Toks[3]);
@@ -274,7 +276,7 @@ public:
 
   RInstruction(const RType &RT, const unsigned Rd, const unsigned Rs1,
                const unsigned Rs2)
-      : RT(RT), Rd(Rd), Rs1(Rs1), Rs2(Rs2) {
+      : Instruction(RT.getOp()), RT(RT), Rd(Rd), Rs1(Rs1), Rs2(Rs2) {
     // FIXME: rename member as _XX?
     setVal((RT.getFunct7().to_ulong() << 25) | (this->Rs2.to_ulong() << 20) |
            (this->Rs1.to_ulong() << 15) | (RT.getFunct3().to_ulong() << 12) |
@@ -310,8 +312,6 @@ public:
     os << "\n";
   }
 
-  std::optional<Exception> exec(Address &, GPRegisters &, Memory &, CSRs &CSRs,
-                                ModeKind &Mode) override;
 };
 
 class UInstruction : public Instruction {
@@ -324,7 +324,7 @@ private:
 public:
   /// This is expected to be used on asm.
   UInstruction(const UJType &UT, const std::vector<std::string> &Toks)
-      : UT(UT) {
+      : Instruction(UT.getOp()), UT(UT) {
     Rd = *findReg(Toks[1]);
     Imm = stoi(Toks[2]);
     setVal((Imm.to_ulong() << 12) | (Rd.to_ulong() << 7) |
@@ -332,7 +332,7 @@ public:
   }
 
   UInstruction(const UJType &UT, const unsigned Rd, const unsigned Imm)
-      : UT(UT), Rd(Rd), Imm(Imm) {
+      : Instruction(UT.getOp()), UT(UT), Rd(Rd), Imm(Imm) {
     // FIXME: rename member as _XX?
     setVal((this->Imm.to_ulong() << 12) | (this->Rd.to_ulong() << 7) |
            UT.getOpcode().to_ulong());
@@ -365,8 +365,6 @@ public:
     os << "(HEX LE)";
     os << "\n";
   }
-  std::optional<Exception> exec(Address &, GPRegisters &, Memory &, CSRs &CSRs,
-                                ModeKind &Mode) override;
 };
 
 class JInstruction : public Instruction {
@@ -379,7 +377,7 @@ private:
 public:
   /// Encoding
   JInstruction(const UJType &JT, const std::vector<std::string> &Toks)
-      : JT(JT) {
+      : Instruction(JT.getOp()), JT(JT) {
     unsigned M0 = 0b100000000000000000000;
     unsigned M1 = 0b000000000011111111110;
     unsigned M2 = 0b000000000100000000000;
@@ -393,7 +391,7 @@ public:
   }
 
   JInstruction(const UJType &JT, const unsigned Rd, const unsigned Imm)
-      : JT(JT), Rd(Rd), Imm(Imm) {
+      : Instruction(JT.getOp()), JT(JT), Rd(Rd), Imm(Imm) {
     unsigned M0 = 0b100000000000000000000;
     unsigned M1 = 0b000000000011111111110;
     unsigned M2 = 0b000000000100000000000;
@@ -429,8 +427,6 @@ public:
     os << "(HEX LE)";
     os << "\n";
   }
-  std::optional<Exception> exec(Address &, GPRegisters &, Memory &, CSRs &CSRs,
-                                ModeKind &Mode) override;
 };
 
 class SInstruction : public Instruction {
@@ -443,7 +439,7 @@ private:
 public:
   /// Encoding.
   SInstruction(const ISBType &ST, const std::vector<std::string> &Toks)
-      : ST(ST) {
+      : Instruction(ST.getOp()), ST(ST) {
 
     // sb/h/w rs2,offset(rs1)
     Rs2 = *findReg(Toks[1]);
@@ -460,7 +456,7 @@ public:
 
   SInstruction(const ISBType &ST, const unsigned Rs1, const unsigned Rs2,
                const unsigned Imm)
-      : ST(ST), Rs1(Rs1), Rs2(Rs2), Imm(Imm) {
+      : Instruction(ST.getOp()), ST(ST), Rs1(Rs1), Rs2(Rs2), Imm(Imm) {
     // FIXME: rename member as _XX?
     unsigned M0 = 0b111111100000;
     unsigned M1 = 0b000000011111;
@@ -497,8 +493,6 @@ public:
     os << "(HEX LE)";
     os << "\n";
   }
-  std::optional<Exception> exec(Address &, GPRegisters &, Memory &, CSRs &CSRs,
-                                ModeKind &Mode) override;
 };
 
 class BInstruction : public Instruction {
@@ -511,7 +505,7 @@ private:
 public:
   /// This is expected to be used on asm.
   BInstruction(const ISBType &BT, const std::vector<std::string> &Toks)
-      : BT(BT) {
+      : Instruction(BT.getOp()), BT(BT) {
 
     Rs1 = *findReg(Toks[1]);
     // TODO: handle label branch
@@ -532,7 +526,7 @@ public:
 
   BInstruction(const ISBType &BT, const unsigned Rs1, const unsigned Rs2,
                const unsigned Imm)
-      : BT(BT), Rs1(Rs1), Rs2(Rs2), Imm(Imm) {
+      : Instruction(BT.getOp()), BT(BT), Rs1(Rs1), Rs2(Rs2), Imm(Imm) {
     // FIXME: rename member as _XX?
     unsigned M0 = 0b1000000000000;
     unsigned M1 = 0b0011111100000;
@@ -571,8 +565,12 @@ public:
     os << "(HEX LE)";
     os << "\n";
   }
-  std::optional<Exception> exec(Address &, GPRegisters &, Memory &, CSRs &CSRs,
-                                ModeKind &Mode) override;
 };
 
+/// Instruction level semantics, which Simulator executes without virtual
+/// dispatch. PC is updated to the next one.
+std::optional<Exception> exec(const DecodedInst &DI, Address &PC,
+                              GPRegisters &GPRegs, Memory &Mem, CSRs &States,
+                              ModeKind &Mode);
+
 #endif
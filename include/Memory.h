@@ -1,27 +1,172 @@
 #ifndef MEMORY_H
 #define MEMORY_H
 #include "CommonTypes.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
 #include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
 #include <optional>
+#include <type_traits>
 #include <vector>
 
+/// Backing store layout of the simulated DRAM.
+enum class MemoryKind {
+  Flat,  // one contiguous buffer of DRAMSize bytes, zero-filled up front.
+  Paged, // 4 KiB pages, allocated (zero-filled) on the first write.
+};
+
 class Memory {
+public:
+  static constexpr unsigned PageBits = 12;
+  static constexpr Address PageSize = 1 << PageBits;
+
 private:
+  MemoryKind Kind;
   std::vector<Byte> DRAM;
+  // Page table for MemoryKind::Paged, indexed by (Ad - DRAMBase) >> PageBits.
+  // nullptr means the page has never been written and reads as zero.
+  std::vector<std::unique_ptr<Byte[]>> Pages;
   Address DRAMSize, DRAMBase;
 
+  // Regions of (1 << CodeRegionBits) bytes which hold decoded instructions,
+  // a store to them is reported to CodeWriteHandlers so that the decoded
+  // copies can be dropped. Regions are smaller than pages so that data next
+  // to code doesn't pay for it.
+  static constexpr unsigned CodeRegionBits = 8;
+  std::vector<std::uint8_t> CodeRegions;
+  std::vector<std::function<void(Address, unsigned)>> CodeWriteHandlers;
+
+  /// translate an address to the offset from DRAMBase with a single range
+  /// check, addresses below DRAMBase wrap around and fail the same check.
+  Address toDRAMAddress(Address Ad, unsigned Size) const {
+    // FIXME: raise access fault for address like x < DRAMSize ?
+    Address DRAMAd = Ad - DRAMBase;
+    if (DRAMSize < Size || DRAMSize - Size < DRAMAd)
+      assert(false && "invalid access out of DRAM");
+    return DRAMAd;
+  }
+
+  /// read a byte on DRAM offset without allocating untouched pages.
+  Byte load(Address DRAMAd) const {
+    if (Kind == MemoryKind::Flat)
+      return DRAM[DRAMAd];
+    const auto &Page = Pages[DRAMAd >> PageBits];
+    return Page ? Page[DRAMAd & (PageSize - 1)] : 0;
+  }
+
+  /// write a byte on DRAM offset, the page is allocated on first touch.
+  void store(Address DRAMAd, Byte Val) { *getPage(DRAMAd) = Val; }
+
+  /// host pointer to DRAM offset for writing, allocates untouched pages.
+  Byte *getPage(Address DRAMAd) {
+    if (Kind == MemoryKind::Flat)
+      return &DRAM[DRAMAd];
+    auto &Page = Pages[DRAMAd >> PageBits];
+    if (!Page)
+      Page = std::make_unique<Byte[]>(PageSize);
+    return &Page[DRAMAd & (PageSize - 1)];
+  }
+
+  /// host pointer to DRAM offset for reading, nullptr on untouched pages.
+  const Byte *findPage(Address DRAMAd) const {
+    if (Kind == MemoryKind::Flat)
+      return &DRAM[DRAMAd];
+    const auto &Page = Pages[DRAMAd >> PageBits];
+    return Page ? &Page[DRAMAd & (PageSize - 1)] : nullptr;
+  }
+
+  // Byte by byte accesses for misaligned (and so maybe page-crossing)
+  // accesses. Those are defined on Memory.cpp.
+  Word readSlow(Address DRAMAd, unsigned Size) const;
+  void writeSlow(Address DRAMAd, Word Val, unsigned Size);
+
+  template <typename T> static constexpr bool isFastPathable() {
+    return std::is_unsigned_v<T> && sizeof(T) <= sizeof(Word) &&
+           std::endian::native == std::endian::little;
+  }
+
 public:
   Memory(const Memory &) = delete;
   Memory &operator=(const Memory &) = delete;
 
-  Memory(Address _DRAMSize = 1 << 10, Address _DRAMBase = 0x8000)
-      : DRAM(_DRAMSize, 0), DRAMSize(_DRAMSize), DRAMBase(_DRAMBase) {}
+  Memory(Address _DRAMSize = 1 << 10, Address _DRAMBase = 0x8000,
+         MemoryKind _Kind = MemoryKind::Flat)
+      : Kind(_Kind), DRAMSize(_DRAMSize), DRAMBase(_DRAMBase) {
+    if (Kind == MemoryKind::Flat)
+      DRAM.resize(DRAMSize, 0);
+    else
+      Pages.resize((DRAMSize + PageSize - 1) >> PageBits);
+    CodeRegions.resize(((DRAMSize - 1) >> CodeRegionBits) + 1, 0);
+  }
+
+  MemoryKind getKind() const { return Kind; }
+  Address getDRAMBase() const { return DRAMBase; }
+  Address getDRAMSize() const { return DRAMSize; }
+
+  void addCodeWriteHandler(std::function<void(Address, unsigned)> Handler) {
+    CodeWriteHandlers.push_back(std::move(Handler));
+  }
+  /// mark [Ad, Ad + Size) as holding decoded instructions.
+  void markCode(Address Ad, Address Size) {
+    Address DRAMAd = toDRAMAddress(Ad, Size);
+    for (Address R = DRAMAd >> CodeRegionBits;
+         R <= (DRAMAd + Size - 1) >> CodeRegionBits; ++R)
+      CodeRegions[R] = 1;
+  }
+  /// unmark all code, every cache behind CodeWriteHandlers must be flushed
+  /// along with.
+  void clearCodeMarks() {
+    std::fill(CodeRegions.begin(), CodeRegions.end(), 0);
+  }
+
+  /// The number of bytes actually backed by host memory.
+  Address getResidentSize() const;
+
+  /// Little endian load of Byte, HalfWord or Word. Naturally aligned accesses
+  /// never cross a page, so they are done by a single host load.
+  template <typename T> T read(Address Ad) const {
+    static_assert(std::is_unsigned_v<T> && sizeof(T) <= sizeof(Word),
+                  "read<T> supports Byte, HalfWord and Word");
+    Address DRAMAd = toDRAMAddress(Ad, sizeof(T));
+    if constexpr (isFastPathable<T>()) {
+      if ((DRAMAd & (sizeof(T) - 1)) == 0) {
+        const Byte *P = findPage(DRAMAd);
+        if (!P)
+          return 0;
+        T Val;
+        std::memcpy(&Val, P, sizeof(T));
+        return Val;
+      }
+    }
+    return readSlow(DRAMAd, sizeof(T));
+  }
+
+  /// Little endian store of Byte, HalfWord or Word.
+  template <typename T> void write(Address Ad, T Val) {
+    static_assert(std::is_unsigned_v<T> && sizeof(T) <= sizeof(Word),
+                  "write<T> supports Byte, HalfWord and Word");
+    Address DRAMAd = toDRAMAddress(Ad, sizeof(T));
+    if (CodeRegions[DRAMAd >> CodeRegionBits] |
+        CodeRegions[(DRAMAd + sizeof(T) - 1) >> CodeRegionBits])
+      for (const auto &Handler : CodeWriteHandlers)
+        Handler(Ad, sizeof(T));
+    if constexpr (isFastPathable<T>()) {
+      if ((DRAMAd & (sizeof(T) - 1)) == 0) {
+        std::memcpy(getPage(DRAMAd), &Val, sizeof(T));
+        return;
+      }
+    }
+    writeSlow(DRAMAd, Val, sizeof(T));
+  }
 
-  void writeByte(Address Ad, Byte Val);
-  Byte readByte(Address Ad);
-  void writeHalfWord(Address Ad, HalfWord Val);
-  HalfWord readHalfWord(Address Ad);
-  void writeWord(Address Ad, Word Val);
-  Word readWord(Address Ad);
+  void writeByte(Address Ad, Byte Val) { write<Byte>(Ad, Val); }
+  Byte readByte(Address Ad) const { return read<Byte>(Ad); }
+  void writeHalfWord(Address Ad, HalfWord Val) { write<HalfWord>(Ad, Val); }
+  HalfWord readHalfWord(Address Ad) const { return read<HalfWord>(Ad); }
+  void writeWord(Address Ad, Word Val) { write<Word>(Ad, Val); }
+  Word readWord(Address Ad) const { return read<Word>(Ad); }
 };
 #endif
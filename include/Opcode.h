@@ -0,0 +1,289 @@
+#ifndef OPCODE_H
+#define OPCODE_H
+
+#include <cstdint>
+#include <string>
+
+/// Dense instruction id. It's set once when an instruction is decoded (or
+/// parsed), and simulators dispatch on it instead of the mnemonic.
+enum class Opcode : std::uint8_t {
+  // I-type
+  ADDI,
+  SLTI,
+  SLTIU,
+  XORI,
+  ORI,
+  ANDI,
+  JALR,
+  LB,
+  LH,
+  LW,
+  LBU,
+  LHU,
+  SLLI,
+  SRLI,
+  SRAI,
+  FENCE,
+  FENCE_I,
+  CSRRW,
+  CSRRS,
+  CSRRC,
+  CSRRWI,
+  CSRRSI,
+  CSRRCI,
+  ECALL,
+  EBREAK,
+  URET,
+  SRET,
+  MRET,
+  EXT,
+  EXTX,
+  // S-type
+  SB,
+  SH,
+  SW,
+  // B-type
+  BEQ,
+  BNE,
+  BLT,
+  BGE,
+  BLTU,
+  BGEU,
+  // R-type
+  ADD,
+  SUB,
+  SLL,
+  SLT,
+  SLTU,
+  XOR,
+  SRL,
+  SRA,
+  OR,
+  AND,
+  MUL,
+  MULH,
+  MULHSU,
+  MULHU,
+  DIV,
+  DIVU,
+  REM,
+  REMU,
+  // U-type
+  LUI,
+  AUIPC,
+  // J-type
+  JAL,
+
+  INVALID,
+};
+
+constexpr unsigned NUM_OPCODES = static_cast<unsigned>(Opcode::INVALID);
+
+enum class InstFormat : std::uint8_t { R, I, S, B, U, J };
+
+namespace OpFlags {
+enum : std::uint8_t {
+  HasRd = 1 << 0,
+  HasRs1 = 1 << 1,
+  HasRs2 = 1 << 2,
+  Branch = 1 << 3, // conditional branches
+  Load = 1 << 4,
+  Store = 1 << 5,
+  CSR = 1 << 6,    // csrrw, csrrs, ...
+  CSRImm = 1 << 7, // csrrwi, csrrsi, ...
+};
+} // namespace OpFlags
+
+// Masks of the fixed bits of an encoding, a word is Op if
+// (Word & Mask) == Match.
+constexpr std::uint32_t MaskOp = 0x0000007f;  // opcode
+constexpr std::uint32_t MaskF3 = 0x0000707f;  // + funct3
+constexpr std::uint32_t MaskF7 = 0xfe00707f;  // + funct7 (or imm[11:5])
+constexpr std::uint32_t MaskF12 = 0xfff0707f; // + funct12 (ecall, ...)
+constexpr std::uint32_t MaskRs2 = 0x01f0007f; // opcode + rs2 (ext, extx)
+
+struct OpcodeInfo {
+  const char *Mnemo;
+  InstFormat Format;
+  std::uint8_t Flags;
+  std::uint32_t Match;
+  std::uint32_t Mask;
+};
+
+/// register operands follow the format, except that rd of I-type system
+/// instructions (ecall, fence, ...) are treated as present like before.
+constexpr OpcodeInfo makeInfo(const char *Mnemo, InstFormat Format,
+                              std::uint32_t Match, std::uint32_t Mask,
+                              std::uint8_t Flags = 0) {
+  switch (Format) {
+  case InstFormat::R:
+    Flags |= OpFlags::HasRd | OpFlags::HasRs1 | OpFlags::HasRs2;
+    break;
+  case InstFormat::I:
+    Flags |= OpFlags::HasRd | OpFlags::HasRs1;
+    break;
+  case InstFormat::S:
+  case InstFormat::B:
+    Flags |= OpFlags::HasRs1 | OpFlags::HasRs2;
+    break;
+  case InstFormat::U:
+  case InstFormat::J:
+    Flags |= OpFlags::HasRd;
+    break;
+  }
+  return {Mnemo, Format, Flags, Match, Mask};
+}
+
+/// The ISA description, indexed by Opcode. The decoder, the assembler and
+/// printers are all derived from this.
+constexpr OpcodeInfo OpcodeInfos[NUM_OPCODES] = {
+    makeInfo("addi", InstFormat::I, 0x00000013, MaskF3),
+    makeInfo("slti", InstFormat::I, 0x00002013, MaskF3),
+    makeInfo("sltiu", InstFormat::I, 0x00003013, MaskF3),
+    makeInfo("xori", InstFormat::I, 0x00004013, MaskF3),
+    makeInfo("ori", InstFormat::I, 0x00006013, MaskF3),
+    makeInfo("andi", InstFormat::I, 0x00007013, MaskF3),
+    makeInfo("jalr", InstFormat::I, 0x00000067, MaskF3),
+    makeInfo("lb", InstFormat::I, 0x00000003, MaskF3, OpFlags::Load),
+    makeInfo("lh", InstFormat::I, 0x00001003, MaskF3, OpFlags::Load),
+    makeInfo("lw", InstFormat::I, 0x00002003, MaskF3, OpFlags::Load),
+    makeInfo("lbu", InstFormat::I, 0x00004003, MaskF3, OpFlags::Load),
+    makeInfo("lhu", InstFormat::I, 0x00005003, MaskF3, OpFlags::Load),
+    makeInfo("slli", InstFormat::I, 0x00001013, MaskF7),
+    makeInfo("srli", InstFormat::I, 0x00005013, MaskF7),
+    makeInfo("srai", InstFormat::I, 0x40005013, MaskF7),
+    makeInfo("fence", InstFormat::I, 0x0000000f, MaskF3),
+    makeInfo("fence.i", InstFormat::I, 0x0000100f, MaskF3),
+    makeInfo("csrrw", InstFormat::I, 0x00001073, MaskF3, OpFlags::CSR),
+    makeInfo("csrrs", InstFormat::I, 0x00002073, MaskF3, OpFlags::CSR),
+    makeInfo("csrrc", InstFormat::I, 0x00003073, MaskF3, OpFlags::CSR),
+    makeInfo("csrrwi", InstFormat::I, 0x00005073, MaskF3,
+             OpFlags::CSR | OpFlags::CSRImm),
+    makeInfo("csrrsi", InstFormat::I, 0x00006073, MaskF3,
+             OpFlags::CSR | OpFlags::CSRImm),
+    makeInfo("csrrci", InstFormat::I, 0x00007073, MaskF3,
+             OpFlags::CSR | OpFlags::CSRImm),
+    makeInfo("ecall", InstFormat::I, 0x00000073, MaskF12),
+    makeInfo("ebreak", InstFormat::I, 0x00100073, MaskF12),
+    makeInfo("uret", InstFormat::I, 0x00200073, MaskF12),
+    makeInfo("sret", InstFormat::I, 0x10200073, MaskF12),
+    makeInfo("mret", InstFormat::I, 0x30200073, MaskF12),
+    makeInfo("ext", InstFormat::I, 0x0010000b, MaskRs2),
+    makeInfo("extx", InstFormat::I, 0x0000000b, MaskRs2),
+    makeInfo("sb", InstFormat::S, 0x00000023, MaskF3, OpFlags::Store),
+    makeInfo("sh", InstFormat::S, 0x00001023, MaskF3, OpFlags::Store),
+    makeInfo("sw", InstFormat::S, 0x00002023, MaskF3, OpFlags::Store),
+    makeInfo("beq", InstFormat::B, 0x00000063, MaskF3, OpFlags::Branch),
+    makeInfo("bne", InstFormat::B, 0x00001063, MaskF3, OpFlags::Branch),
+    makeInfo("blt", InstFormat::B, 0x00004063, MaskF3, OpFlags::Branch),
+    makeInfo("bge", InstFormat::B, 0x00005063, MaskF3, OpFlags::Branch),
+    makeInfo("bltu", InstFormat::B, 0x00006063, MaskF3, OpFlags::Branch),
+    makeInfo("bgeu", InstFormat::B, 0x00007063, MaskF3, OpFlags::Branch),
+    makeInfo("add", InstFormat::R, 0x00000033, MaskF7),
+    makeInfo("sub", InstFormat::R, 0x40000033, MaskF7),
+    makeInfo("sll", InstFormat::R, 0x00001033, MaskF7),
+    makeInfo("slt", InstFormat::R, 0x00002033, MaskF7),
+    makeInfo("sltu", InstFormat::R, 0x00003033, MaskF7),
+    makeInfo("xor", InstFormat::R, 0x00004033, MaskF7),
+    makeInfo("srl", InstFormat::R, 0x00005033, MaskF7),
+    makeInfo("sra", InstFormat::R, 0x40005033, MaskF7),
+    makeInfo("or", InstFormat::R, 0x00006033, MaskF7),
+    makeInfo("and", InstFormat::R, 0x00007033, MaskF7),
+    makeInfo("mul", InstFormat::R, 0x02000033, MaskF7),
+    makeInfo("mulh", InstFormat::R, 0x02001033, MaskF7),
+    makeInfo("mulhsu", InstFormat::R, 0x02002033, MaskF7),
+    makeInfo("mulhu", InstFormat::R, 0x02003033, MaskF7),
+    makeInfo("div", InstFormat::R, 0x02004033, MaskF7),
+    makeInfo("divu", InstFormat::R, 0x02005033, MaskF7),
+    makeInfo("rem", InstFormat::R, 0x02006033, MaskF7),
+    makeInfo("remu", InstFormat::R, 0x02007033, MaskF7),
+    makeInfo("lui", InstFormat::U, 0x00000037, MaskOp),
+    makeInfo("auipc", InstFormat::U, 0x00000017, MaskOp),
+    makeInfo("jal", InstFormat::J, 0x0000006f, MaskOp),
+};
+
+inline const OpcodeInfo &getOpcodeInfo(Opcode Op) {
+  return OpcodeInfos[static_cast<unsigned>(Op)];
+}
+inline InstFormat getFormat(Opcode Op) { return getOpcodeInfo(Op).Format; }
+inline bool hasFlag(Opcode Op, std::uint8_t Flag) {
+  return getOpcodeInfo(Op).Flags & Flag;
+}
+inline bool isBranch(Opcode Op) { return hasFlag(Op, OpFlags::Branch); }
+inline bool isLoad(Opcode Op) { return hasFlag(Op, OpFlags::Load); }
+inline bool isStore(Opcode Op) { return hasFlag(Op, OpFlags::Store); }
+inline bool isCSR(Opcode Op) { return hasFlag(Op, OpFlags::CSR); }
+inline bool isCSRImm(Opcode Op) { return hasFlag(Op, OpFlags::CSRImm); }
+/// csr*, environment calls, trap returns, fence.i and the extensions, which
+/// touch states other than GPRs and memory or may raise an exception.
+inline bool isSystem(Opcode Op) {
+  switch (Op) {
+  case Opcode::FENCE_I:
+  case Opcode::ECALL:
+  case Opcode::EBREAK:
+  case Opcode::URET:
+  case Opcode::SRET:
+  case Opcode::MRET:
+  case Opcode::EXT:
+  case Opcode::EXTX:
+    return true;
+  default:
+    return isCSR(Op);
+  }
+}
+
+/// Two level lookup from an instruction word: opcode[6:2] and funct3 select
+/// a short list of candidates, which are checked by their mask. Encodings
+/// which don't use funct3 (lui, jal, ...) appear under every funct3.
+struct DecodeTable {
+  static constexpr unsigned MaxCandidates = 5; // ecall, ebreak, *ret
+  Opcode Entries[32][8][MaxCandidates];
+};
+
+constexpr DecodeTable makeDecodeTable() {
+  DecodeTable T{};
+  for (auto &Major : T.Entries)
+    for (auto &Cands : Major)
+      for (auto &Op : Cands)
+        Op = Opcode::INVALID;
+
+  for (unsigned i = 0; i < NUM_OPCODES; ++i) {
+    const OpcodeInfo &Info = OpcodeInfos[i];
+    for (std::uint32_t Funct3 = 0; Funct3 < 8; ++Funct3) {
+      if (((Funct3 << 12) & Info.Mask) != (Info.Match & Info.Mask & 0x7000))
+        continue;
+      auto &Cands = T.Entries[(Info.Match >> 2) & 0x1f][Funct3];
+      unsigned Slot = 0;
+      while (Cands[Slot] != Opcode::INVALID)
+        ++Slot; // fails to compile if MaxCandidates is too small.
+      Cands[Slot] = static_cast<Opcode>(i);
+    }
+  }
+  return T;
+}
+
+inline constexpr DecodeTable OpcodeDecodeTable = makeDecodeTable();
+
+/// Opcode of an instruction word, INVALID if it isn't a RV32IM instruction
+/// this simulator knows.
+inline Opcode decodeOpcode(std::uint32_t Val) {
+  for (Opcode Op :
+       OpcodeDecodeTable.Entries[(Val >> 2) & 0x1f][(Val >> 12) & 0x7]) {
+    if (Op == Opcode::INVALID)
+      break;
+    const OpcodeInfo &Info = getOpcodeInfo(Op);
+    if ((Val & Info.Mask) == Info.Match)
+      return Op;
+  }
+  return Opcode::INVALID;
+}
+
+/// Slow lookup by mnemonic, only for constructing instructions.
+inline Opcode findOpcode(const std::string &Mnemo) {
+  for (unsigned i = 0; i < NUM_OPCODES; ++i)
+    if (Mnemo == OpcodeInfos[i].Mnemo)
+      return static_cast<Opcode>(i);
+  return Opcode::INVALID;
+}
+
+#endif
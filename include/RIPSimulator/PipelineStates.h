@@ -2,9 +2,12 @@
 #define PIPELINESTATES_H
 
 #include <CommonTypes.h>
-#include <Instructions.h>
+#include <DecodedInst.h>
+#include <cassert>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
 
 const unsigned STAGENUM = 5;
@@ -48,8 +51,13 @@ private:
 
   std::optional<Address> BranchPC;
 
-  // pipeline bubbles are nullptr
-  std::unique_ptr<Instruction> Insts[STAGENUM];
+  /// Pipeline latch of a stage, which holds a copy of the decoded instruction
+  /// so that proceeding a cycle doesn't allocate. Bubbles are not Valid.
+  struct StageSlot {
+    DecodedInst Inst;
+    bool Valid;
+  };
+  StageSlot Slots[STAGENUM];
   Address PCs[STAGENUM];
 
   bool StalledStages[STAGENUM];
@@ -62,7 +70,7 @@ public:
   PipelineStates()
       : DERs2Val(0), DECSRVal(0), DEImmVal(0), EXRdVal(0), EXRs2Val(0),
         EXImmVal(0), EXCSRVal(0), MARdVal(0), MAImmVal(0), MACSRVal(0),
-        WBImmVal(0), StalledStages{0}, InvalidStages{0} {}
+        WBImmVal(0), Slots{}, StalledStages{0}, InvalidStages{0} {}
 
   void dump();
   void printJSON(std::ostream &);
@@ -131,28 +139,29 @@ public:
   const bool isInvalid(const STAGES &S) { return InvalidStages[S]; }
   void setInvalid(const STAGES &S) { InvalidStages[S] = true; }
 
-  const std::unique_ptr<Instruction> &operator[](STAGES Stage) const {
+  /// decoded instruction on the stage, nullptr for a bubble.
+  const DecodedInst *operator[](STAGES Stage) const {
     assert(Stage < STAGENUM && "Index out of bounds");
-    return Insts[Stage];
+    return Slots[Stage].Valid ? &Slots[Stage].Inst : nullptr;
   }
 
-  std::unique_ptr<Instruction> &operator[](STAGES Stage) {
-    assert(Stage < STAGENUM && "Index out of bounds");
-    return Insts[Stage];
-  }
-
-  void proceed(std::unique_ptr<Instruction> InstPtr) {
+  /// Inst is copied into IF, nullptr makes a bubble.
+  void proceed(const DecodedInst *Inst) {
     for (int Stage = STAGES::WB; STAGES::IF < Stage; --Stage) {
       if (isStall((STAGES)(Stage - 1)))
         return;
-      Insts[Stage] = std::move(Insts[Stage - 1]);
+      Slots[Stage] = Slots[Stage - 1];
+      // a stall on the previous stage leaves this bubble behind.
+      Slots[Stage - 1].Valid = false;
     }
-    Insts[STAGES::IF] = std::move(InstPtr);
+    Slots[STAGES::IF].Valid = Inst != nullptr;
+    if (Inst)
+      Slots[STAGES::IF].Inst = *Inst;
   }
 
   bool isEmpty() {
     for (int Stage = STAGES::IF; Stage <= STAGES::WB; ++Stage) {
-      if (Insts[Stage] != nullptr)
+      if (Slots[Stage].Valid)
         return false;
     }
     return true;
@@ -161,7 +170,7 @@ public:
   void fillBubble() {
     for (int Stage = STAGES::IF; Stage <= STAGES::WB; ++Stage) {
       if (InvalidStages[Stage]) {
-        Insts[Stage] = nullptr;
+        Slots[Stage].Valid = false;
         InvalidStages[Stage] = false;
       }
     }
@@ -2,6 +2,7 @@
 #ifndef RIPSIMULATOR_H
 #define RIPSIMULATOR_H
 #include "BranchPredictor.h"
+#include "DecodeCache.h"
 #include "Decoder.h"
 #include "Exceptions.h"
 #include "InstructionTypes.h"
@@ -27,6 +28,7 @@ private:
   PipelineStates PS;
   GPRegisters GPRegs;
   Decoder Dec;
+  DecodeCache DC;
 
   // options
   std::unique_ptr<BranchPredictor> BP;
@@ -43,7 +45,8 @@ public:
                    Statistics>(), // FIXME: default option is not dump, is this
                                   // good? and currently reversed.
                Address DRAMBase = 0x8000,
-               std::optional<Address> SPIValue = std::nullopt);
+               std::optional<Address> SPIValue = std::nullopt,
+               MemoryKind MemKind = MemoryKind::Flat);
   bool getBPPred() {
     if (BP)
       return BP->getPrevPred();
@@ -77,6 +80,7 @@ public:
   void dumpCSRegs() { States.dump(); }
   void dumpStats();
   Address &getPC() { return PC; }
+  const DecodeCache &getDecodeCache() const { return DC; }
   void setPC(Address Ad) { PC = Ad; };
 };
 
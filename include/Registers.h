@@ -85,6 +85,9 @@ public:
     return Regs[index];
   }
 
+  /// raw register file for compiled code, which must keep x0 zero.
+  RegVal *data() { return Regs; }
+
   const RegVal &operator[](std::string name) const {
     auto IT = GPRegMap.find(name);
     assert(IT != GPRegMap.end() && "No such registers.");
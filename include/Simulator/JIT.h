@@ -0,0 +1,65 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "BlockCache.h"
+#include "CSR.h"
+#include "CommonTypes.h"
+#include "Memory.h"
+#include "Registers.h"
+#include <cstddef>
+#include <cstdint>
+
+// The JIT emits x86-64 code for System V hosts, others run blocks by the
+// interpreter.
+#if defined(__x86_64__) && defined(__linux__) && !defined(NO_JIT)
+#define SIMULATOR_HAS_JIT 1
+#else
+#define SIMULATOR_HAS_JIT 0
+#endif
+
+/// Machine states which compiled blocks touch through helpers.
+struct JITContext {
+  GPRegisters *GPRegs;
+  Memory *Mem;
+  CSRs *States;
+  ModeKind *Mode;
+  /// the running block, a store clearing its Valid stops the block.
+  const BasicBlock *Block;
+};
+
+/// The next PC and the number of executed instructions of a block run.
+struct JITResult {
+  std::uint64_t NextPC;
+  std::uint64_t Executed;
+};
+
+using JITFunction = JITResult (*)(RegVal *Regs, JITContext *Ctx);
+
+/// Translates basic blocks to host machine code.
+///
+/// A compiled block runs the instructions of BasicBlock::Insts up to a
+/// trailing system instruction, which is left to the interpreter. Branches
+/// and jumps return the next PC, and a store overwriting the block itself
+/// returns early. Code is bump allocated and is only freed by reset().
+class JITCompiler {
+  Byte *Code = nullptr;
+  std::size_t Capacity = 0;
+  std::size_t Used = 0;
+
+public:
+  JITCompiler(const JITCompiler &) = delete;
+  JITCompiler &operator=(const JITCompiler &) = delete;
+
+  JITCompiler(std::size_t Capacity = 16 << 20);
+  ~JITCompiler();
+
+  /// returns the compiled B, nullptr if B can't be compiled on this host.
+  JITFunction compile(const BasicBlock &B);
+
+  /// whether the code buffer may not hold one more block.
+  bool isFull() const;
+  /// drop all code, compiled blocks must be dropped beforehand.
+  void reset() { Used = 0; }
+};
+
+#endif
@@ -1,12 +1,15 @@
 
 #ifndef SIMULATOR_H
 #define SIMULATOR_H
+#include "BlockCache.h"
 #include "CSR.h"
+#include "DecodeCache.h"
 #include "Decoder.h"
 #include "InstructionTypes.h"
 #include "Instructions.h"
 #include "Memory.h"
 #include "Registers.h"
+#include "Simulator/JIT.h"
 #include "Statistics.h"
 #include <memory>
 #include <string>
@@ -16,12 +19,23 @@ class Simulator {
 private:
   Decoder Dec;
   Memory Mem;
+  DecodeCache DC;
+  BlockCache BC;
   unsigned CodeSize;
   Address PC;
   CSRs States;
   ModeKind Mode;
   GPRegisters GPRegs;
   Statistics Stats;
+  std::unique_ptr<JITCompiler> JIT;
+  /// blocks executed more than this are compiled by runJIT().
+  unsigned JITThreshold = 50;
+
+  /// execute DI on PC with the exception handling, and count it on
+  /// statistics. returns false if the simulation stops.
+  bool step(const DecodedInst &DI);
+  /// the loop of runBlocks() and runJIT(), Compiler may be nullptr.
+  void runBlockLoop(std::optional<Address> EndAddress, JITCompiler *Compiler);
 
 public:
   Simulator(const Simulator &) = delete;
@@ -29,13 +43,27 @@ public:
 
   Simulator(std::istream &is, Address DRAMSize = 1 << 10,
             Address DRAMBase = 0x8000,
-            std::optional<Address> SPIValue = std::nullopt);
+            std::optional<Address> SPIValue = std::nullopt,
+            MemoryKind MemKind = MemoryKind::Flat);
 
   inline const GPRegisters &getGPRegs() const { return GPRegs; }
   inline const CSRs &getCSRs() const { return States; }
 
   void run(std::optional<Address> StartAddress = std::nullopt,
            std::optional<Address> EndAddress = std::nullopt);
+  /// Same as run(), but pre-translates the loaded image and dispatches on it
+  /// by threaded code. Defined on ThreadedRun.cpp.
+  void runThreaded(std::optional<Address> StartAddress = std::nullopt,
+                   std::optional<Address> EndAddress = std::nullopt);
+  /// Same as run(), but executes cached basic blocks which are chained to
+  /// their successors. Defined on BlockRun.cpp.
+  void runBlocks(std::optional<Address> StartAddress = std::nullopt,
+                 std::optional<Address> EndAddress = std::nullopt);
+  /// Same as runBlocks(), but hot blocks are compiled to host code. Blocks
+  /// are interpreted if the host isn't supported. Defined on BlockRun.cpp.
+  void runJIT(std::optional<Address> StartAddress = std::nullopt,
+              std::optional<Address> EndAddress = std::nullopt);
+  void setJITThreshold(unsigned Threshold) { JITThreshold = Threshold; }
   void execRISCVTESTS();
   // void execDhrystone();
 
@@ -43,6 +71,8 @@ public:
   inline const void dumpStats() {
     std::cerr << "========== BEGIN STATS ============"
               << "\n";
+    Stats.setDecodeCacheCounts(DC.getHits(), DC.getMisses());
+    Stats.setBlockCounts(BC.getBlockCounts());
     Stats.printAllStatistics(std::cerr);
 
     std::cerr << "=========== END STATS ============="
@@ -50,6 +80,8 @@ public:
     std::cerr << "\n";
   }
   inline const Address &getPC() const { return PC; }
+  inline const Memory &getMemory() const { return Mem; }
+  inline const Statistics &getStats() const { return Stats; }
 };
 
 #endif
@@ -1,9 +1,14 @@
 
 #ifndef STATISTICS_H
 #define STATISTICS_H
+#include "CommonTypes.h"
+#include <algorithm>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <string>
+#include <vector>
 
 class Statistics {
 private:
@@ -12,31 +17,108 @@ private:
   std::map<unsigned, unsigned> BDists;
   /// The each number of executed instructions on runtime.
   std::map<std::string, unsigned> InstCounts;
+  /// hits and misses of the decoded instruction cache.
+  std::uint64_t DecodeCacheHits, DecodeCacheMisses;
+  /// execution counts of basic blocks by entry PC.
+  std::map<Address, std::uint64_t> BlockCounts;
+  /// hits of fused instruction pairs by the name of the pair.
+  std::map<std::string, std::uint64_t> FusionCounts;
 
 public:
   Statistics(const Statistics &) = delete;
   Statistics &operator=(const Statistics &) = delete;
 
-  Statistics() : BDist(0) {}
+  Statistics() : BDist(0), DecodeCacheHits(0), DecodeCacheMisses(0) {}
 
   void incrementBDist() { BDist++; }
-  void addInst(std::string &Mnemo) {
+  unsigned getBDist() const { return BDist; }
+  void setBDist(unsigned Dist) { BDist = Dist; }
+
+  void addInst(const std::string &Mnemo, unsigned Cnt = 1) {
     if (auto IT = InstCounts.find(Mnemo); IT != InstCounts.end()) {
-      IT->second++;
+      IT->second += Cnt;
     } else {
-      InstCounts.insert({Mnemo, 1});
+      InstCounts.insert({Mnemo, Cnt});
     }
   }
 
-  void addBDistAndReset() {
-    if (auto IT = BDists.find(BDist); IT != BDists.end()) {
-      IT->second++;
+  const std::map<std::string, unsigned> &getInstCounts() const {
+    return InstCounts;
+  }
+
+  /// record Cnt branches of the distance Dist, BDist is untouched.
+  void addBDist(unsigned Dist, unsigned Cnt = 1) {
+    if (auto IT = BDists.find(Dist); IT != BDists.end()) {
+      IT->second += Cnt;
     } else {
-      BDists.insert({BDist, 1});
+      BDists.insert({Dist, Cnt});
     }
+  }
+
+  void addBDistAndReset() {
+    addBDist(BDist);
     BDist = 0;
   }
 
+  void setDecodeCacheCounts(std::uint64_t Hits, std::uint64_t Misses) {
+    DecodeCacheHits = Hits;
+    DecodeCacheMisses = Misses;
+  }
+  std::uint64_t getDecodeCacheHits() const { return DecodeCacheHits; }
+  std::uint64_t getDecodeCacheMisses() const { return DecodeCacheMisses; }
+
+  void printDecodeCache(std::ostream &os) {
+    std::uint64_t Total = DecodeCacheHits + DecodeCacheMisses;
+    os << std::dec << "Decode Cache: " << DecodeCacheHits << " hits, "
+       << DecodeCacheMisses << " misses";
+    if (Total)
+      os << " (" << std::fixed << std::setprecision(2)
+         << 100.0 * DecodeCacheHits / Total << "% hit)";
+    os << "\n";
+  }
+
+  void setBlockCounts(std::map<Address, std::uint64_t> Counts) {
+    BlockCounts = std::move(Counts);
+  }
+  const std::map<Address, std::uint64_t> &getBlockCounts() const {
+    return BlockCounts;
+  }
+
+  void addFusion(const std::string &Name, std::uint64_t Cnt = 1) {
+    FusionCounts[Name] += Cnt;
+  }
+  const std::map<std::string, std::uint64_t> &getFusionCounts() const {
+    return FusionCounts;
+  }
+
+  /// print hits of fused pairs, nothing if no pair was fused.
+  void printFusions(std::ostream &os) {
+    if (FusionCounts.empty())
+      return;
+    os << "Fused Pairs: \n";
+    os << std::dec;
+    for (const auto &[Name, Cnt] : FusionCounts)
+      os << "  " << std::setfill(' ') << std::setw(10) << Name << " | " << Cnt
+         << "\n";
+  }
+
+  /// print the most executed blocks, nothing if blocks weren't formed.
+  void printHotBlocks(std::ostream &os, unsigned N = 10) {
+    if (BlockCounts.empty())
+      return;
+    std::vector<std::pair<Address, std::uint64_t>> Hot(BlockCounts.begin(),
+                                                       BlockCounts.end());
+    std::stable_sort(Hot.begin(), Hot.end(), [](const auto &L, const auto &R) {
+      return L.second > R.second;
+    });
+    if (N < Hot.size())
+      Hot.resize(N);
+    os << "Hot Blocks: \n";
+    for (const auto &[PC, Cnt] : Hot)
+      os << "  0x" << std::hex << std::setfill('0') << std::setw(8) << PC
+         << std::dec << std::setfill(' ') << " | " << Cnt << "\n";
+  }
+
   void printBDists(std::ostream &os) {
     os << "Branches Distances: \n";
     unsigned LFCnt = 0;
@@ -66,6 +148,9 @@ public:
   void printAllStatistics(std::ostream &os) {
     printInstCounts(os);
     printBDists(os);
+    printDecodeCache(os);
+    printHotBlocks(os);
+    printFusions(os);
   }
 };
 #endif
\ No newline at end of file
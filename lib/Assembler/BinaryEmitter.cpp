@@ -14,39 +14,40 @@ void BinaryEmitter::emitBinary(std::ostream &os) {
     auto &Toks = AP.getTokens();
     auto &Mnemo = Toks[0];
 
+    Opcode Op = findOpcode(Mnemo);
+    if (Op == Opcode::INVALID) {
+      std::cerr << Mnemo << "\n";
+      assert(false && "unimplemented!");
+      continue;
+    }
+
     std::unique_ptr<Instruction> InstT;
-    if (auto IT = ITypeKinds.find(Mnemo); IT != ITypeKinds.end()) {
+    switch (getFormat(Op)) {
+    case InstFormat::I:
       assert((Toks.size() == 4 || Toks.size() == 3) &&
              "Wrong token number I-Type Inst.");
-      auto UI = std::make_unique<IInstruction>(IT->second, Toks);
-      InstT = std::move(UI);
-
-    } else if (auto IT = RTypeKinds.find(Mnemo); IT != RTypeKinds.end()) {
+      InstT = std::make_unique<IInstruction>(ITypeKinds.at(Mnemo), Toks);
+      break;
+    case InstFormat::R:
       assert(Toks.size() == 4 && "Wrong token number R-Type Inst.");
-      auto UI = std::make_unique<RInstruction>(IT->second, Toks);
-      InstT = std::move(UI);
-
-    } else if (auto IT = UTypeKinds.find(Mnemo); IT != UTypeKinds.end()) {
+      InstT = std::make_unique<RInstruction>(RTypeKinds.at(Mnemo), Toks);
+      break;
+    case InstFormat::U:
       assert(Toks.size() == 3 && "Wrong token number for U-Type Inst.");
-      auto UI = std::make_unique<UInstruction>(IT->second, Toks);
-      InstT = std::move(UI);
-
-    } else if (auto IT = JTypeKinds.find(Mnemo); IT != JTypeKinds.end()) {
+      InstT = std::make_unique<UInstruction>(UTypeKinds.at(Mnemo), Toks);
+      break;
+    case InstFormat::J:
       assert(Toks.size() == 3 && "Wrong token number for J-Type Inst.");
-      auto UI = std::make_unique<JInstruction>(IT->second, Toks);
-      InstT = std::move(UI);
-    } else if (auto IT = STypeKinds.find(Mnemo); IT != STypeKinds.end()) {
+      InstT = std::make_unique<JInstruction>(JTypeKinds.at(Mnemo), Toks);
+      break;
+    case InstFormat::S:
       assert(Toks.size() == 3 && "Wrong token number for S-Type Inst.");
-      auto UI = std::make_unique<SInstruction>(IT->second, Toks);
-      InstT = std::move(UI);
-    } else if (auto IT = BTypeKinds.find(Mnemo); IT != BTypeKinds.end()) {
+      InstT = std::make_unique<SInstruction>(STypeKinds.at(Mnemo), Toks);
+      break;
+    case InstFormat::B:
       assert(Toks.size() == 4 && "Wrong token number for B-Type Inst.");
-      auto UI = std::make_unique<BInstruction>(IT->second, Toks);
-      InstT = std::move(UI);
-
-    } else {
-      std::cerr << Mnemo << "\n";
-      assert(false && "unimplemented!");
+      InstT = std::make_unique<BInstruction>(BTypeKinds.at(Mnemo), Toks);
+      break;
     }
 
     DEBUG_ONLY(debugInstOnAsm(Toks, InstT->getVal()));
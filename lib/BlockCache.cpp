@@ -0,0 +1,133 @@
+#include "BlockCache.h"
+
+namespace {
+
+/// instructions which end a block.
+bool isBlockEnd(Opcode Op) {
+  return isBranch(Op) || Op == Opcode::JAL || Op == Opcode::JALR ||
+         isSystem(Op);
+}
+
+} // namespace
+
+BlockCache::BlockCache(Memory &Mem)
+    : Mem(Mem),
+      Pages((Mem.getDRAMSize() + Memory::PageSize - 1) >> Memory::PageBits) {
+  Mem.addCodeWriteHandler(
+      [this](Address Ad, unsigned Size) { invalidate(Ad, Size); });
+}
+
+BasicBlock *BlockCache::translate(Address PC) {
+  ++Misses;
+  Address Off = PC - Mem.getDRAMBase();
+  // misaligned PCs and PCs out of DRAM are not executable.
+  if (Mem.getDRAMSize() <= Off || (Off & (sizeof(Word) - 1)) != 0)
+    return nullptr;
+
+  auto Block = std::make_unique<BasicBlock>();
+  Block->EntryPC = PC;
+  Address Ad = PC;
+  do {
+    if (StopAddress && Ad == *StopAddress && Ad != PC)
+      break;
+    Word Val = Mem.read<Word>(Ad);
+    Opcode Op = decodeOpcode(Val);
+    if (Op == Opcode::INVALID)
+      break;
+    Block->Insts.push_back(makeDecodedInst(Op, Val));
+    Ad += sizeof(Word);
+    if (isBlockEnd(Op))
+      break;
+  } while (Block->Insts.size() < MaxBlockInsts &&
+           ((Ad - Mem.getDRAMBase()) & (Memory::PageSize - 1)) != 0 &&
+           Ad - Mem.getDRAMBase() < Mem.getDRAMSize());
+  // the end of program.
+  if (Block->Insts.empty())
+    return nullptr;
+
+  const DecodedInst &Last = Block->Insts.back();
+  Address LastPC = Ad - sizeof(Word);
+  Block->Succs[0] = {Ad, nullptr, 0};
+  if (Last.isBranch() || Last.Op == Opcode::JAL)
+    Block->Succs[1] = {LastPC + Last.Imm, nullptr, 0};
+  else
+    Block->Succs[1] = Block->Succs[0];
+
+  auto &Page = Pages[Off >> Memory::PageBits];
+  if (!Page)
+    Page = std::make_unique<BlockPage>();
+  Mem.markCode(PC, Block->Insts.size() * sizeof(Word));
+  Address Idx = (Off & (Memory::PageSize - 1)) / sizeof(Word);
+  for (Address i = 0; i < Block->Insts.size(); ++i)
+    Page->Covered.set(Idx + i);
+  auto &Entry = Page->Blocks[Idx];
+  Entry = std::move(Block);
+  return Entry.get();
+}
+
+void BlockCache::retire(BlockPtr &Block) {
+  Block->Valid = false;
+  if (Block->ExecCount)
+    RetiredCounts[Block->EntryPC] += Block->ExecCount;
+  Retired.push_back(std::move(Block));
+  ++Epoch;
+}
+
+void BlockCache::setStopAddress(std::optional<Address> Ad) {
+  if (Ad == StopAddress)
+    return;
+  StopAddress = Ad;
+  flush();
+}
+
+void BlockCache::invalidate(Address Ad, unsigned Size) {
+  Address Begin = (Ad - Mem.getDRAMBase()) & ~(sizeof(Word) - 1);
+  Address End = Ad - Mem.getDRAMBase() + Size;
+  bool Covered = false;
+  for (Address Off = Begin; Off < End && Off < Mem.getDRAMSize();
+       Off += sizeof(Word))
+    if (const auto &Page = Pages[Off >> Memory::PageBits])
+      Covered |= Page->Covered[(Off & (Memory::PageSize - 1)) / sizeof(Word)];
+  if (!Covered)
+    return;
+
+  // blocks don't cross pages, so only the blocks starting on the same page
+  // up to MaxBlockInsts words before can overlap.
+  Address PageBegin = Begin & ~(Memory::PageSize - 1);
+  Address Reach = (MaxBlockInsts - 1) * sizeof(Word);
+  Begin = Begin - PageBegin < Reach ? PageBegin : Begin - Reach;
+  for (Address Off = Begin; Off < End; Off += sizeof(Word)) {
+    if (Mem.getDRAMSize() <= Off)
+      break;
+    auto &Page = Pages[Off >> Memory::PageBits];
+    if (!Page)
+      continue;
+    auto &Block = Page->Blocks[(Off & (Memory::PageSize - 1)) / sizeof(Word)];
+    if (Block && Ad - Mem.getDRAMBase() <
+                     Off + Block->Insts.size() * sizeof(Word))
+      retire(Block);
+  }
+}
+
+void BlockCache::flush() {
+  for (auto &Page : Pages) {
+    if (!Page)
+      continue;
+    for (auto &Block : Page->Blocks)
+      if (Block)
+        retire(Block);
+    Page = nullptr;
+  }
+}
+
+std::map<Address, std::uint64_t> BlockCache::getBlockCounts() const {
+  auto Counts = RetiredCounts;
+  for (const auto &Page : Pages) {
+    if (!Page)
+      continue;
+    for (const auto &Block : Page->Blocks)
+      if (Block && Block->ExecCount)
+        Counts[Block->EntryPC] += Block->ExecCount;
+  }
+  return Counts;
+}
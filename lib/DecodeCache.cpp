@@ -0,0 +1,41 @@
+#include "DecodeCache.h"
+
+DecodeCache::DecodeCache(Memory &Mem, Decoder &Dec)
+    : Mem(Mem), Dec(Dec),
+      Pages((Mem.getDRAMSize() + Memory::PageSize - 1) >> Memory::PageBits) {
+  Mem.addCodeWriteHandler(
+      [this](Address Ad, unsigned Size) { invalidate(Ad, Size); });
+}
+
+DecodeCache::InstPtr DecodeCache::fill(Address PC) {
+  ++Misses;
+  InstPtr Inst = Dec.decode(Mem.read<Word>(PC));
+  Address Off = PC - Mem.getDRAMBase();
+  // misaligned PCs and the end of program (nullptr) are not cached.
+  if (!Inst || (Off & (sizeof(Word) - 1)) != 0)
+    return Inst;
+
+  auto &Page = Pages[Off >> Memory::PageBits];
+  if (!Page)
+    Page = std::make_unique<InstPtr[]>(EntriesPerPage);
+  Mem.markCode(PC, sizeof(Word));
+  Page[(Off & (Memory::PageSize - 1)) / sizeof(Word)] = Inst;
+  return Inst;
+}
+
+void DecodeCache::invalidate(Address Ad, unsigned Size) {
+  Address Begin = (Ad - Mem.getDRAMBase()) & ~(sizeof(Word) - 1);
+  Address End = Ad - Mem.getDRAMBase() + Size;
+  for (Address Off = Begin; Off < End; Off += sizeof(Word)) {
+    if (Mem.getDRAMSize() <= Off)
+      break;
+    if (auto &Page = Pages[Off >> Memory::PageBits])
+      Page[(Off & (Memory::PageSize - 1)) / sizeof(Word)] = nullptr;
+  }
+}
+
+void DecodeCache::flush() {
+  for (auto &Page : Pages)
+    Page = nullptr;
+  Mem.clearCodeMarks();
+}
@@ -1,124 +1,160 @@
 #include "Instructions.h"
 #include <limits>
 
-std::optional<Exception> IInstruction::exec(Address &PC, GPRegisters &GPRegs,
-                                            Memory &Mem, CSRs &States,
-                                            ModeKind &Mode) {
-  std::string Mnemo = IT.getMnemo();
-  int ImmI = signExtend(Imm);
-  if (Mnemo == "addi") {
+std::optional<Exception> exec(const DecodedInst &DI, Address &PC,
+                              GPRegisters &GPRegs, Memory &Mem, CSRs &States,
+                              ModeKind &Mode) {
+  switch (DI.Op) {
+  // I-type
+  case Opcode::ADDI: {
     // To avoid signed overflow.
     union {
       unsigned un;
       int in;
-    } u = {.un = (unsigned)GPRegs[Rs1.to_ulong()] + (unsigned)ImmI};
-    GPRegs.write(Rd.to_ulong(), u.in);
+    } u = {.un = (unsigned)GPRegs[DI.Rs1] + (unsigned)DI.Imm};
+    GPRegs.write(DI.Rd, u.in);
     PC += 4;
-  } else if (Mnemo == "slti") {
-    GPRegs.write(Rd.to_ulong(), (signed)GPRegs[Rs1.to_ulong()] < ImmI);
+    break;
+  }
+  case Opcode::SLTI:
+    GPRegs.write(DI.Rd, (signed)GPRegs[DI.Rs1] < DI.Imm);
     PC += 4;
-  } else if (Mnemo == "sltiu") {
-    GPRegs.write(Rd.to_ulong(),
-                 (unsigned)GPRegs[Rs1.to_ulong()] < (unsigned)ImmI);
+    break;
+  case Opcode::SLTIU:
+    GPRegs.write(DI.Rd,
+                 (unsigned)GPRegs[DI.Rs1] < (unsigned)DI.Imm);
     PC += 4;
-  } else if (Mnemo == "xori") {
-    GPRegs.write(Rd.to_ulong(), (unsigned)GPRegs[Rs1.to_ulong()] ^ ImmI);
+    break;
+  case Opcode::XORI:
+    GPRegs.write(DI.Rd, (unsigned)GPRegs[DI.Rs1] ^ DI.Imm);
     PC += 4;
-  } else if (Mnemo == "ori") {
+    break;
+  case Opcode::ORI:
     // FIXME: sext?
-    GPRegs.write(Rd.to_ulong(), (unsigned)GPRegs[Rs1.to_ulong()] | ImmI);
+    GPRegs.write(DI.Rd, (unsigned)GPRegs[DI.Rs1] | DI.Imm);
     PC += 4;
-  } else if (Mnemo == "andi") {
-    GPRegs.write(Rd.to_ulong(), (unsigned)GPRegs[Rs1.to_ulong()] & ImmI);
+    break;
+  case Opcode::ANDI:
+    GPRegs.write(DI.Rd, (unsigned)GPRegs[DI.Rs1] & DI.Imm);
     PC += 4;
-  } else if (Mnemo == "jalr") {
+    break;
+  case Opcode::JALR: {
     // FIXME: should addresss calculation be wrapped?
     Address CurPC = PC;
-    PC = (GPRegs[Rs1.to_ulong()] + ImmI) & ~1;
-    GPRegs.write(Rd.to_ulong(), CurPC + 4);
-  } else if (Mnemo == "lb") {
+    PC = (GPRegs[DI.Rs1] + DI.Imm) & ~1;
+    GPRegs.write(DI.Rd, CurPC + 4);
+    break;
+  }
+  case Opcode::LB: {
     // FIXME: unsigned to signed safe cast (not implementation defined way)
-    Byte V = Mem.readByte(GPRegs[Rs1.to_ulong()] + ImmI);
-    GPRegs.write(Rd.to_ulong(), (signed char)V);
+    Byte V = Mem.readByte(GPRegs[DI.Rs1] + DI.Imm);
+    GPRegs.write(DI.Rd, (signed char)V);
     PC += 4;
-  } else if (Mnemo == "lh") {
+    break;
+  }
+  case Opcode::LH: {
     // FIXME: unsigned to signed safe cast (not implementation defined way)
-    HalfWord V = Mem.readHalfWord(GPRegs[Rs1.to_ulong()] + ImmI);
-    GPRegs.write(Rd.to_ulong(), (signed short)V);
+    HalfWord V = Mem.readHalfWord(GPRegs[DI.Rs1] + DI.Imm);
+    GPRegs.write(DI.Rd, (signed short)V);
     PC += 4;
-  } else if (Mnemo == "lw") {
+    break;
+  }
+  case Opcode::LW: {
     // FIXME: unsigned to signed safe cast (not implementation defined way)
-    Word V = Mem.readWord(GPRegs[Rs1.to_ulong()] + ImmI);
-    GPRegs.write(Rd.to_ulong(), (signed)V);
+    Word V = Mem.readWord(GPRegs[DI.Rs1] + DI.Imm);
+    GPRegs.write(DI.Rd, (signed)V);
     PC += 4;
-  } else if (Mnemo == "lbu") {
+    break;
+  }
+  case Opcode::LBU: {
     // FIXME: unsigned to signed safe cast (not implementation defined way)
-    Byte V = Mem.readByte(GPRegs[Rs1.to_ulong()] + ImmI);
-    GPRegs.write(Rd.to_ulong(), (unsigned char)V);
+    Byte V = Mem.readByte(GPRegs[DI.Rs1] + DI.Imm);
+    GPRegs.write(DI.Rd, (unsigned char)V);
     PC += 4;
-  } else if (Mnemo == "lhu") {
-    HalfWord V = Mem.readHalfWord(GPRegs[Rs1.to_ulong()] + ImmI);
-    GPRegs.write(Rd.to_ulong(), (unsigned short)V);
+    break;
+  }
+  case Opcode::LHU: {
+    HalfWord V = Mem.readHalfWord(GPRegs[DI.Rs1] + DI.Imm);
+    GPRegs.write(DI.Rd, (unsigned short)V);
     PC += 4;
-  } else if (Mnemo == "slli") { // FIXME: shamt
+    break;
+  }
+  case Opcode::SLLI: // FIXME: shamt
     // FIXME: sext?
-    GPRegs.write(Rd.to_ulong(),
-                 (unsigned)GPRegs[Rs1.to_ulong()] << Imm.to_ulong());
+    GPRegs.write(DI.Rd,
+                 (unsigned)GPRegs[DI.Rs1] << (DI.Imm & 0b11111));
     PC += 4;
-  } else if (Mnemo == "srli") {
-    GPRegs.write(Rd.to_ulong(),
-                 (unsigned)GPRegs[Rs1.to_ulong()] >> Imm.to_ulong());
+    break;
+  case Opcode::SRLI:
+    GPRegs.write(DI.Rd,
+                 (unsigned)GPRegs[DI.Rs1] >> (DI.Imm & 0b11111));
     PC += 4;
-  } else if (Mnemo == "srai") {
-    GPRegs.write(Rd.to_ulong(),
-                 (signed)GPRegs[Rs1.to_ulong()] >> Imm.to_ulong());
+    break;
+  case Opcode::SRAI:
+    GPRegs.write(DI.Rd,
+                 (signed)GPRegs[DI.Rs1] >> (DI.Imm & 0b11111));
     PC += 4;
-  } else if (Mnemo == "fence") {
+    break;
+  case Opcode::FENCE:
     // FIXME: currently expected to be nop
     PC += 4;
-  } else if (Mnemo == "fence.i") {
+    break;
+  case Opcode::FENCE_I:
     // FIXME: currently expected to be nop
     PC += 4;
-  } else if (Mnemo == "csrrw") {
-    CSRAddress CA = Imm.to_ulong() & 0xfff;
+    break;
+  case Opcode::CSRRW: {
+    CSRAddress CA = DI.getCSRAddr();
     CSRVal CV = States.read(CA);
-    States.write(CA, GPRegs[Rs1.to_ulong()]);
-    GPRegs.write(Rd.to_ulong(), CV);
+    States.write(CA, GPRegs[DI.Rs1]);
+    GPRegs.write(DI.Rd, CV);
     PC += 4;
-  } else if (Mnemo == "csrrs") {
-    CSRAddress CA = Imm.to_ulong() & 0xfff;
+    break;
+  }
+  case Opcode::CSRRS: {
+    CSRAddress CA = DI.getCSRAddr();
     CSRVal CV = States.read(CA);
-    States.write(CA, GPRegs[Rs1.to_ulong()] | CV);
-    GPRegs.write(Rd.to_ulong(), CV);
+    States.write(CA, GPRegs[DI.Rs1] | CV);
+    GPRegs.write(DI.Rd, CV);
     PC += 4;
-  } else if (Mnemo == "csrrc") {
-    CSRAddress CA = Imm.to_ulong() & 0xfff;
+    break;
+  }
+  case Opcode::CSRRC: {
+    CSRAddress CA = DI.getCSRAddr();
     CSRVal CV = States.read(CA);
-    States.write(CA, GPRegs[Rs1.to_ulong()] & !CV);
-    GPRegs.write(Rd.to_ulong(), CV);
+    States.write(CA, GPRegs[DI.Rs1] & !CV);
+    GPRegs.write(DI.Rd, CV);
     PC += 4;
-  } else if (Mnemo == "csrrwi") {
-    CSRAddress CA = Imm.to_ulong() & 0xfff;
+    break;
+  }
+  case Opcode::CSRRWI: {
+    CSRAddress CA = DI.getCSRAddr();
     CSRVal CV = States.read(CA);
-    CSRVal ZImm = Rs1.to_ulong();
+    CSRVal ZImm = DI.Rs1;
     States.write(CA, ZImm);
-    GPRegs.write(Rd.to_ulong(), CV);
+    GPRegs.write(DI.Rd, CV);
     PC += 4;
-  } else if (Mnemo == "csrrsi") {
-    CSRAddress CA = Imm.to_ulong() & 0xfff;
+    break;
+  }
+  case Opcode::CSRRSI: {
+    CSRAddress CA = DI.getCSRAddr();
     CSRVal CV = States.read(CA);
-    CSRVal ZImm = Rs1.to_ulong();
+    CSRVal ZImm = DI.Rs1;
     States.write(CA, CV | ZImm);
-    GPRegs.write(Rd.to_ulong(), CV);
+    GPRegs.write(DI.Rd, CV);
     PC += 4;
-  } else if (Mnemo == "csrrci") {
-    CSRAddress CA = Imm.to_ulong() & 0xfff;
+    break;
+  }
+  case Opcode::CSRRCI: {
+    CSRAddress CA = DI.getCSRAddr();
     CSRVal CV = States.read(CA);
-    CSRVal ZImm = Rs1.to_ulong();
+    CSRVal ZImm = DI.Rs1;
     States.write(CA, CV & !ZImm);
-    GPRegs.write(Rd.to_ulong(), CV);
+    GPRegs.write(DI.Rd, CV);
     PC += 4;
-  } else if (Mnemo == "ecall") {
+    break;
+  }
+  case Opcode::ECALL:
     if (Mode == ModeKind::User) {
       return Exception::EnvironmentCallFromUMode;
     } else if (Mode == ModeKind::Supervisor) {
@@ -129,17 +165,17 @@ std::optional<Exception> IInstruction::exec(Address &PC, GPRegisters &GPRegs,
       // FIXME: is this illegal inst?
       return Exception::IllegalInstruction;
     }
-  } else if (Mnemo == "ebreak") {
+  case Opcode::EBREAK:
     return Exception::Breakpoint;
-  } else if (Mnemo == "uret") {
+  case Opcode::URET:
     // TODO: uret
     assert(false && "uret: unimplemented!");
     return Exception::IllegalInstruction;
-  } else if (Mnemo == "sret") {
+  case Opcode::SRET:
     // TODO: sret
     assert(false && "sret: unimplemented!");
     return Exception::IllegalInstruction;
-  } else if (Mnemo == "mret") {
+  case Opcode::MRET: {
     // FIXME: make constant on CSR.h
     PC = States.read(MEPC);
     // FIXME: add MSTATUS handle methods?
@@ -174,253 +210,234 @@ std::optional<Exception> IInstruction::exec(Address &PC, GPRegisters &GPRegs,
     // Set MPP to 0
     ResVal &= 0xffffe7ff;
     States.write(MSTATUS, ResVal);
-  } else if (Mnemo == "ext") {
+    break;
+  }
+  case Opcode::EXT:
     PC += 4;
     return R0;
-  } else if (Mnemo == "extx") {
+  case Opcode::EXTX:
     PC += 4;
     return R1;
-  } else {
-    assert(false && "unimplemented! or not exist");
-    return Exception::IllegalInstruction;
-  }
-  return std::nullopt;
-}
-
-std::optional<Exception> RInstruction::exec(Address &PC, GPRegisters &GPRegs,
-                                            Memory &Mem, CSRs &States,
-                                            ModeKind &Mode) {
-  std::string Mnemo = RT.getMnemo();
-  if (Mnemo == "add") {
+  // R-type
+  case Opcode::ADD: {
     // To avoid signed overflow.
     union {
       unsigned un;
       int in;
-    } u = {.un = (unsigned)GPRegs[Rs1.to_ulong()] +
-                 (unsigned)GPRegs[Rs2.to_ulong()]};
-    GPRegs.write(Rd.to_ulong(), u.in);
+    } u = {.un = (unsigned)GPRegs[DI.Rs1] +
+                 (unsigned)GPRegs[DI.Rs2]};
+    GPRegs.write(DI.Rd, u.in);
     PC += 4;
-  } else if (Mnemo == "sub") {
+    break;
+  }
+  case Opcode::SUB: {
     // To avoid signed overflow.
     union {
       unsigned un;
       int in;
-    } u = {.un = (unsigned)GPRegs[Rs1.to_ulong()] -
-                 (unsigned)GPRegs[Rs2.to_ulong()]};
-    GPRegs.write(Rd.to_ulong(), u.in);
-    PC += 4;
-  } else if (Mnemo == "sll") {
-    GPRegs.write(Rd.to_ulong(),
-                 GPRegs[Rs1.to_ulong()] << (GPRegs[Rs2.to_ulong()] & 0b11111));
-    PC += 4;
-  } else if (Mnemo == "slt") {
-    GPRegs.write(Rd.to_ulong(),
-                 GPRegs[Rs1.to_ulong()] < GPRegs[Rs2.to_ulong()]);
-    PC += 4;
-  } else if (Mnemo == "sltu") {
-    GPRegs.write(Rd.to_ulong(), (unsigned)GPRegs[Rs1.to_ulong()] <
-                                    (unsigned)GPRegs[Rs2.to_ulong()]);
-    PC += 4;
-  } else if (Mnemo == "xor") {
-    GPRegs.write(Rd.to_ulong(),
-                 GPRegs[Rs1.to_ulong()] ^ GPRegs[Rs2.to_ulong()]);
+    } u = {.un = (unsigned)GPRegs[DI.Rs1] -
+                 (unsigned)GPRegs[DI.Rs2]};
+    GPRegs.write(DI.Rd, u.in);
     PC += 4;
-  } else if (Mnemo == "srl") {
-    GPRegs.write(Rd.to_ulong(), (unsigned)GPRegs[Rs1.to_ulong()] >>
-                                    (GPRegs[Rs2.to_ulong()] & 0b11111));
-    PC += 4;
-  } else if (Mnemo == "sra") {
-    GPRegs.write(Rd.to_ulong(), (signed)GPRegs[Rs1.to_ulong()] >>
-                                    (signed)(GPRegs[Rs2.to_ulong()] & 0b11111));
-    PC += 4;
-  } else if (Mnemo == "or") {
-    GPRegs.write(Rd.to_ulong(),
-                 GPRegs[Rs1.to_ulong()] | GPRegs[Rs2.to_ulong()]);
-    PC += 4;
-  } else if (Mnemo == "and") {
-    GPRegs.write(Rd.to_ulong(),
-                 GPRegs[Rs1.to_ulong()] & GPRegs[Rs2.to_ulong()]);
-    PC += 4;
-  } else if (Mnemo == "mul") {
-    GPRegs.write(Rd.to_ulong(), ((signed long long)GPRegs[Rs1.to_ulong()] *
-                                 (signed long long)GPRegs[Rs2.to_ulong()]) &
+    break;
+  }
+  case Opcode::SLL:
+    GPRegs.write(DI.Rd,
+                 GPRegs[DI.Rs1] << (GPRegs[DI.Rs2] & 0b11111));
+    PC += 4;
+    break;
+  case Opcode::SLT:
+    GPRegs.write(DI.Rd,
+                 GPRegs[DI.Rs1] < GPRegs[DI.Rs2]);
+    PC += 4;
+    break;
+  case Opcode::SLTU:
+    GPRegs.write(DI.Rd, (unsigned)GPRegs[DI.Rs1] <
+                                    (unsigned)GPRegs[DI.Rs2]);
+    PC += 4;
+    break;
+  case Opcode::XOR:
+    GPRegs.write(DI.Rd,
+                 GPRegs[DI.Rs1] ^ GPRegs[DI.Rs2]);
+    PC += 4;
+    break;
+  case Opcode::SRL:
+    GPRegs.write(DI.Rd, (unsigned)GPRegs[DI.Rs1] >>
+                                    (GPRegs[DI.Rs2] & 0b11111));
+    PC += 4;
+    break;
+  case Opcode::SRA:
+    GPRegs.write(DI.Rd, (signed)GPRegs[DI.Rs1] >>
+                                    (signed)(GPRegs[DI.Rs2] & 0b11111));
+    PC += 4;
+    break;
+  case Opcode::OR:
+    GPRegs.write(DI.Rd,
+                 GPRegs[DI.Rs1] | GPRegs[DI.Rs2]);
+    PC += 4;
+    break;
+  case Opcode::AND:
+    GPRegs.write(DI.Rd,
+                 GPRegs[DI.Rs1] & GPRegs[DI.Rs2]);
+    PC += 4;
+    break;
+  case Opcode::MUL:
+    GPRegs.write(DI.Rd, ((signed long long)GPRegs[DI.Rs1] *
+                                 (signed long long)GPRegs[DI.Rs2]) &
                                     0xffffffff);
     PC += 4;
-  } else if (Mnemo == "mulh") {
-    GPRegs.write(Rd.to_ulong(), ((signed long long)GPRegs[Rs1.to_ulong()] *
-                                 (signed long long)GPRegs[Rs2.to_ulong()]) >>
+    break;
+  case Opcode::MULH:
+    GPRegs.write(DI.Rd, ((signed long long)GPRegs[DI.Rs1] *
+                                 (signed long long)GPRegs[DI.Rs2]) >>
                                     32);
     PC += 4;
-  } else if (Mnemo == "mulhsu") {
-    GPRegs.write(Rd.to_ulong(),
-                 ((signed long long)GPRegs[Rs1.to_ulong()] *
-                  (unsigned long long)(unsigned int)GPRegs[Rs2.to_ulong()]) >>
+    break;
+  case Opcode::MULHSU:
+    GPRegs.write(DI.Rd,
+                 ((signed long long)GPRegs[DI.Rs1] *
+                  (unsigned long long)(unsigned int)GPRegs[DI.Rs2]) >>
                      32);
     PC += 4;
-  } else if (Mnemo == "mulhu") {
-    GPRegs.write(Rd.to_ulong(),
-                 ((unsigned long long)(unsigned int)GPRegs[Rs1.to_ulong()] *
-                  (unsigned long long)(unsigned int)GPRegs[Rs2.to_ulong()]) >>
+    break;
+  case Opcode::MULHU:
+    GPRegs.write(DI.Rd,
+                 ((unsigned long long)(unsigned int)GPRegs[DI.Rs1] *
+                  (unsigned long long)(unsigned int)GPRegs[DI.Rs2]) >>
                      32);
     PC += 4;
-  } else if (Mnemo == "div") {
+    break;
+  case Opcode::DIV: {
     // FIXME: set DV zero register?
-    RegVal Divisor = GPRegs[Rs2.to_ulong()], Dividend = GPRegs[Rs1.to_ulong()];
+    RegVal Divisor = GPRegs[DI.Rs2], Dividend = GPRegs[DI.Rs1];
     if (Divisor == 0) {
-      GPRegs.write(Rd.to_ulong(), -1);
+      GPRegs.write(DI.Rd, -1);
     } else if (Dividend == std::numeric_limits<std::int32_t>::min() &&
                Divisor == -1) {
-      GPRegs.write(Rd.to_ulong(), std::numeric_limits<std::int32_t>::min());
+      GPRegs.write(DI.Rd, std::numeric_limits<std::int32_t>::min());
     } else {
-      GPRegs.write(Rd.to_ulong(), Dividend / Divisor);
+      GPRegs.write(DI.Rd, Dividend / Divisor);
     }
     PC += 4;
-  } else if (Mnemo == "divu") {
-    RegVal Divisor = GPRegs[Rs2.to_ulong()], Dividend = GPRegs[Rs1.to_ulong()];
+    break;
+  }
+  case Opcode::DIVU: {
+    RegVal Divisor = GPRegs[DI.Rs2], Dividend = GPRegs[DI.Rs1];
     if (Divisor == 0) {
-      GPRegs.write(Rd.to_ulong(), std::numeric_limits<std::uint32_t>::max());
+      GPRegs.write(DI.Rd, std::numeric_limits<std::uint32_t>::max());
     } else {
-      GPRegs.write(Rd.to_ulong(),
+      GPRegs.write(DI.Rd,
                    (unsigned int)Dividend / (unsigned int)Divisor);
     }
     PC += 4;
-  } else if (Mnemo == "rem") {
-    RegVal Divisor = GPRegs[Rs2.to_ulong()], Dividend = GPRegs[Rs1.to_ulong()];
+    break;
+  }
+  case Opcode::REM: {
+    RegVal Divisor = GPRegs[DI.Rs2], Dividend = GPRegs[DI.Rs1];
     if (Divisor == 0) {
-      GPRegs.write(Rd.to_ulong(), Dividend);
+      GPRegs.write(DI.Rd, Dividend);
     } else if (Dividend == std::numeric_limits<std::int32_t>::min() &&
                Divisor == -1) {
-      GPRegs.write(Rd.to_ulong(), 0);
+      GPRegs.write(DI.Rd, 0);
     } else {
-      GPRegs.write(Rd.to_ulong(),
-                   GPRegs[Rs1.to_ulong()] % GPRegs[Rs2.to_ulong()]);
+      GPRegs.write(DI.Rd,
+                   GPRegs[DI.Rs1] % GPRegs[DI.Rs2]);
     }
     PC += 4;
-  } else if (Mnemo == "remu") {
-    RegVal Divisor = GPRegs[Rs2.to_ulong()], Dividend = GPRegs[Rs1.to_ulong()];
+    break;
+  }
+  case Opcode::REMU: {
+    RegVal Divisor = GPRegs[DI.Rs2], Dividend = GPRegs[DI.Rs1];
     if (Divisor == 0) {
-      GPRegs.write(Rd.to_ulong(), Dividend);
+      GPRegs.write(DI.Rd, Dividend);
     } else {
-      GPRegs.write(Rd.to_ulong(), (unsigned int)GPRegs[Rs1.to_ulong()] %
-                                      (unsigned int)GPRegs[Rs2.to_ulong()]);
+      GPRegs.write(DI.Rd, (unsigned int)GPRegs[DI.Rs1] %
+                                      (unsigned int)GPRegs[DI.Rs2]);
     }
     PC += 4;
-  } else
-    assert(false && "unimplemented! or not exist");
-  return std::nullopt;
-}
-
-std::optional<Exception> UInstruction::exec(Address &PC, GPRegisters &GPRegs,
-                                            Memory &Mem, CSRs &States,
-                                            ModeKind &Mode) {
-  std::string Mnemo = UT.getMnemo();
-  int ImmI = signExtend(Imm);
-
-  if (Mnemo == "lui") {
-    GPRegs.write(Rd.to_ulong(), ImmI << 12);
-    PC += 4;
-  } else if (Mnemo == "auipc") {
-    GPRegs.write(Rd.to_ulong(), PC + (ImmI << 12));
-    PC += 4;
-  } else
-    assert(false && "not exist");
-  return std::nullopt;
-}
-
-std::optional<Exception> SInstruction::exec(Address &PC, GPRegisters &GPRegs,
-                                            Memory &Mem, CSRs &States,
-                                            ModeKind &Mode) {
-  std::string Mnemo = ST.getMnemo();
-
-  int ImmI = signExtend(Imm);
-
-  Address Ad = GPRegs[Rs1.to_ulong()] + ImmI;
-  if ((unsigned)Ad == 0x10000000) { // picorv32 Dhrystone MMIO
-    std::cerr << (char)GPRegs[Rs2.to_ulong()];
-    PC += 4;
-    return std::nullopt;
-  }
-  if (Mode == ModeKind::Epilogue) {
-    std::cerr << "Epilogue:" << GPRegs[Rs2.to_ulong()] << "is written to " << Ad
-              << '\n';
-    PC += 4;
-    return std::nullopt;
+    break;
   }
-  if (Mnemo == "sb") {
-    // FIXME: wrap add?
-    Address Ad = GPRegs[Rs1.to_ulong()] + ImmI;
-    Mem.writeByte(Ad, GPRegs[Rs2.to_ulong()]);
-    PC += 4;
-  } else if (Mnemo == "sh") {
-    // FIXME: wrap add?
-    Address Ad = GPRegs[Rs1.to_ulong()] + ImmI;
-    Mem.writeHalfWord(Ad, GPRegs[Rs2.to_ulong()]);
-    PC += 4;
-  } else if (Mnemo == "sw") {
+  // U-type
+  case Opcode::LUI:
+    GPRegs.write(DI.Rd, DI.Imm << 12);
+    PC += 4;
+    break;
+  case Opcode::AUIPC:
+    GPRegs.write(DI.Rd, PC + (DI.Imm << 12));
+    PC += 4;
+    break;
+  // S-type
+  case Opcode::SB:
+  case Opcode::SH:
+  case Opcode::SW: {
     // FIXME: wrap add?
-    Address Ad = GPRegs[Rs1.to_ulong()] + ImmI;
-    Mem.writeWord(Ad, GPRegs[Rs2.to_ulong()]);
+    Address Ad = GPRegs[DI.Rs1] + DI.Imm;
+    if ((unsigned)Ad == 0x10000000) { // picorv32 Dhrystone MMIO
+      std::cerr << (char)GPRegs[DI.Rs2];
+    } else if (Mode == ModeKind::Epilogue) {
+      std::cerr << "Epilogue:" << GPRegs[DI.Rs2] << "is written to " << Ad
+                << '\n';
+    } else if (DI.Op == Opcode::SB) {
+      Mem.writeByte(Ad, GPRegs[DI.Rs2]);
+    } else if (DI.Op == Opcode::SH) {
+      Mem.writeHalfWord(Ad, GPRegs[DI.Rs2]);
+    } else {
+      Mem.writeWord(Ad, GPRegs[DI.Rs2]);
+    }
     PC += 4;
-  } else
-    assert(false && "unimplemented! or not exist");
-  return std::nullopt;
-}
-
-std::optional<Exception> BInstruction::exec(Address &PC, GPRegisters &GPRegs,
-                                            Memory &Mem, CSRs &States,
-                                            ModeKind &Mode) {
-  std::string Mnemo = BT.getMnemo();
-  int ImmI = signExtend(Imm);
-  if (Mnemo == "beq") {
-    if (GPRegs[Rs1.to_ulong()] == GPRegs[Rs2.to_ulong()]) {
-      PC += ImmI;
+    break;
+  }
+  // B-type
+  case Opcode::BEQ:
+    if (GPRegs[DI.Rs1] == GPRegs[DI.Rs2]) {
+      PC += DI.Imm;
     } else {
       PC += 4;
     }
-  } else if (Mnemo == "bne") {
-    if (GPRegs[Rs1.to_ulong()] != GPRegs[Rs2.to_ulong()]) {
-      PC += ImmI;
+    break;
+  case Opcode::BNE:
+    if (GPRegs[DI.Rs1] != GPRegs[DI.Rs2]) {
+      PC += DI.Imm;
     } else {
       PC += 4;
     }
-  } else if (Mnemo == "blt") {
-    if (GPRegs[Rs1.to_ulong()] < GPRegs[Rs2.to_ulong()]) {
-      PC += ImmI;
+    break;
+  case Opcode::BLT:
+    if (GPRegs[DI.Rs1] < GPRegs[DI.Rs2]) {
+      PC += DI.Imm;
     } else {
       PC += 4;
     }
-  } else if (Mnemo == "bge") {
-    if (GPRegs[Rs1.to_ulong()] >= GPRegs[Rs2.to_ulong()]) {
-      PC += ImmI;
+    break;
+  case Opcode::BGE:
+    if (GPRegs[DI.Rs1] >= GPRegs[DI.Rs2]) {
+      PC += DI.Imm;
     } else {
       PC += 4;
     }
-  } else if (Mnemo == "bltu") {
-    if ((unsigned)GPRegs[Rs1.to_ulong()] < (unsigned)GPRegs[Rs2.to_ulong()]) {
-      PC += ImmI;
+    break;
+  case Opcode::BLTU:
+    if ((unsigned)GPRegs[DI.Rs1] < (unsigned)GPRegs[DI.Rs2]) {
+      PC += DI.Imm;
     } else {
       PC += 4;
     }
-  } else if (Mnemo == "bgeu") {
-    if ((unsigned)GPRegs[Rs1.to_ulong()] >= (unsigned)GPRegs[Rs2.to_ulong()]) {
-      PC += ImmI;
+    break;
+  case Opcode::BGEU:
+    if ((unsigned)GPRegs[DI.Rs1] >= (unsigned)GPRegs[DI.Rs2]) {
+      PC += DI.Imm;
     } else {
       PC += 4;
     }
-  } else
-    assert(false && "unimplemented! or not exist");
-  return std::nullopt;
-}
-
-std::optional<Exception> JInstruction::exec(Address &PC, GPRegisters &GPRegs,
-                                            Memory &Mem, CSRs &States,
-                                            ModeKind &Mode) {
-  std::string Mnemo = JT.getMnemo();
-  int ImmI = signExtend(Imm);
-  if (Mnemo == "jal") {
-    GPRegs.write(Rd.to_ulong(), PC + 4);
-    PC += ImmI;
-  } else
+    break;
+  // J-type
+  case Opcode::JAL:
+    GPRegs.write(DI.Rd, PC + 4);
+    PC += DI.Imm;
+    break;
+  default:
     assert(false && "unimplemented! or not exist");
+    return Exception::IllegalInstruction;
+  }
   return std::nullopt;
 }
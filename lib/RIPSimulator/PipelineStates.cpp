@@ -1,5 +1,6 @@
 #include "RIPSimulator/PipelineStates.h"
 #include "RIPSimulator/Interactive.h"
+#include "Decoder.h"
 
 #include <sstream>
 
@@ -10,9 +11,9 @@ void PipelineStates::dump() {
     if (isStall((STAGES)Stage))
       std::cerr << std::hex << "(Stalled) ";
 
-    if (Insts[Stage] != nullptr) {
+    if (Slots[Stage].Valid) {
       std::cerr << std::hex << "PC=0x" << PCs[Stage] << " ";
-      Insts[Stage]->mprint(std::cerr);
+      Decoder().decode(Slots[Stage].Inst.Val)->mprint(std::cerr);
       std::cerr << ", ";
     } else
       std::cerr << "Bubble, ";
@@ -49,21 +50,21 @@ void PipelineStates::printJSON(std::ostream &os) {
   JTotal["Kind"] = JSONKindToString(JSONKind::PipelineStates);
   for (int Stage = STAGES::IF; Stage <= STAGES::WB; ++Stage) {
     nlohmann::json JStage;
-    if (!Insts[Stage]) {
+    if (!Slots[Stage].Valid) {
       JStage["isBubble"] = true;
       continue;
     }
     JStage["isBubble"] = false;
 
     JStage["isStall"] = isStall((STAGES)Stage);
-    // TODO: decode correctly.
-    // ;
+    // latches only hold the decoded form, decode again for printing.
+    const DecodedInst &Inst = Slots[Stage].Inst;
     std::stringstream ss;
-    Insts[Stage]->mprint(ss);
+    Decoder().decode(Inst.Val)->mprint(ss);
     JStage["InstStr"] = ss.str();
-    JStage["InstVal"] = Insts[Stage]->getVal();
+    JStage["InstVal"] = Inst.Val;
 
-    JStage["mnemo"] = Insts[Stage]->getMnemo();
+    JStage["mnemo"] = getOpcodeInfo(Inst.Op).Mnemo;
     JStage["PC"] = PCs[Stage];
 
     // TODO: dump stage specific info.
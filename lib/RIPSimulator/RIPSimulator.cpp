@@ -1,32 +1,18 @@
 #include "RIPSimulator/RIPSimulator.h"
-#include <cmath>
 #include <iostream>
 #include <nlohmann/json.hpp>
 #include <set>
 
-namespace {
-/// BitWidth < 32
-int signExtend(const unsigned Imm, unsigned BitWidth) {
-  if ((Imm >> (BitWidth - 1)) & 1) {
-    return (~0 ^ ((int)(pow(2, BitWidth) - 1))) | (signed)Imm;
-  } else {
-    return Imm;
-  }
-}
-
-} // namespace
-
-const std::set<std::string> CSR_INSTs = {"csrrw",  "csrrs",  "csrrc",
-                                         "csrrwi", "csrrsi", "csrrci"};
-
 RIPSimulator::RIPSimulator(std::istream &is,
                            std::unique_ptr<BranchPredictor> BP,
                            Address _DRAMSize,
                            std::unique_ptr<Statistics> _Stats,
-                           Address _DRAMBase, std::optional<Address> SPIValue)
-    : Mem(_DRAMSize, _DRAMBase), PC(_DRAMBase), Mode(ModeKind::Machine),
-      NumStages(0), GPRegs(_DRAMSize, _DRAMBase, SPIValue), BP(std::move(BP)),
-      Stats(std::move(_Stats)) {
+                           Address _DRAMBase, std::optional<Address> SPIValue,
+                           MemoryKind MemKind)
+    : Mem(_DRAMSize, _DRAMBase, MemKind), PC(_DRAMBase),
+      Mode(ModeKind::Machine), NumStages(0),
+      GPRegs(_DRAMSize, _DRAMBase, SPIValue), DC(Mem, Dec),
+      BP(std::move(BP)), Stats(std::move(_Stats)) {
 
   // TODO: parse per 2 bytes for compressed instructions
   char Buff[4];
@@ -46,6 +32,8 @@ void RIPSimulator::dumpStats() {
             << "\n";
   std::cerr << std::dec << "Total stages: " << NumStages << "\n";
 
+  Stats->setDecodeCacheCounts(DC.getHits(), DC.getMisses());
+
   Stats->printAllStatistics(std::cerr);
 
   if (BP)
@@ -56,68 +44,84 @@ void RIPSimulator::dumpStats() {
 }
 
 void RIPSimulator::writeback(GPRegisters &, PipelineStates &) {
-  const auto &Inst = PS[STAGES::WB];
-  // FIXME: use it just in time, generally.
-  std::string Mnemo = Inst->getMnemo();
+  const DecodedInst &Inst = *PS[STAGES::WB];
+  Opcode Op = Inst.Op;
   RegVal Res = 0;
 
-  if (BTypeKinds.count(Mnemo) || STypeKinds.count(Mnemo) || Mnemo == "fence" ||
-      Mnemo == "fence.i") { // FIXME: how about other insts?
+  if (isBranch(Op) || isStore(Op) || Op == Opcode::FENCE ||
+      Op == Opcode::FENCE_I) { // FIXME: how about other insts?
     // Instructions without writeback
     // TODO: don't set any value and return early.
     PS.setWBImmVal(0);
-  } else if (CSR_INSTs.count(Mnemo)) {
+  } else if (isCSR(Op)) {
     RegVal RdVal = PS.getMARdVal();
     RegVal CV = PS.getMACSRVal();
 
     RegVal CSRAddr = PS.getMAImmVal() & 0xfff;
 
     States.write(CSRAddr, CV);
-    GPRegs.write(Inst->getRd(), RdVal);
+    GPRegs.write(Inst.Rd, RdVal);
 
   } else {
     // Instructions with writeback
     Res = PS.getMARdVal();
-    GPRegs.write(Inst->getRd(), PS.getMARdVal());
+    GPRegs.write(Inst.Rd, PS.getMARdVal());
   }
   PS.setWBImmVal(Res);
 }
 
 void RIPSimulator::memoryaccess(Memory &, PipelineStates &) {
-  const auto &Inst = PS[STAGES::MA];
+  const DecodedInst &Inst = *PS[STAGES::MA];
   const RegVal MARdVal = PS.getEXRdVal();
   const RegVal MACSRVal = PS.getEXCSRVal();
   RegVal Res = MARdVal;
   unsigned Imm = PS.getEXImmVal();
-  std::string Mnemo = Inst->getMnemo();
   // FIXME: dhrystone MMIO
   if ((unsigned)MARdVal == 0x10000000) {
     std::cerr << (char)MARdVal;
   } else if (Mode == ModeKind::Epilogue) {
     std::cerr << "Epilogue:" << MARdVal << "is written to " << PS.getEXRs2Val()
               << '\n';
-  } else if (Mnemo == "sw") {
-    Mem.writeWord((unsigned)MARdVal, PS.getEXRs2Val());
-  } else if (Mnemo == "sh") {
-    Mem.writeHalfWord((unsigned)MARdVal, PS.getEXRs2Val());
-  } else if (Mnemo == "sb") {
-    Mem.writeByte((unsigned)MARdVal, PS.getEXRs2Val());
-  } else if (Mnemo == "lw") {
-    // FIXME: unsigned to signed safe cast (not implementation defined way)
-    Word V = Mem.readWord(MARdVal);
-    Res = (signed)V;
-  } else if (Mnemo == "lh") {
-    HalfWord V = Mem.readHalfWord((unsigned)MARdVal);
-    Res = (signed short)V;
-  } else if (Mnemo == "lbu") {
-    Byte V = Mem.readByte((unsigned)MARdVal);
-    Res = (unsigned char)V;
-  } else if (Mnemo == "lhu") {
-    HalfWord V = Mem.readHalfWord((unsigned)MARdVal);
-    Res = (unsigned short)V;
-  } else if (Mnemo == "lb") {
-    Byte V = Mem.readByte((unsigned)MARdVal);
-    Res = (signed char)V;
+  } else {
+    switch (Inst.Op) {
+    case Opcode::SW:
+      Mem.writeWord((unsigned)MARdVal, PS.getEXRs2Val());
+      break;
+    case Opcode::SH:
+      Mem.writeHalfWord((unsigned)MARdVal, PS.getEXRs2Val());
+      break;
+    case Opcode::SB:
+      Mem.writeByte((unsigned)MARdVal, PS.getEXRs2Val());
+      break;
+    case Opcode::LW: {
+      // FIXME: unsigned to signed safe cast (not implementation defined way)
+      Word V = Mem.readWord(MARdVal);
+      Res = (signed)V;
+      break;
+    }
+    case Opcode::LH: {
+      HalfWord V = Mem.readHalfWord((unsigned)MARdVal);
+      Res = (signed short)V;
+      break;
+    }
+    case Opcode::LBU: {
+      Byte V = Mem.readByte((unsigned)MARdVal);
+      Res = (unsigned char)V;
+      break;
+    }
+    case Opcode::LHU: {
+      HalfWord V = Mem.readHalfWord((unsigned)MARdVal);
+      Res = (unsigned short)V;
+      break;
+    }
+    case Opcode::LB: {
+      Byte V = Mem.readByte((unsigned)MARdVal);
+      Res = (signed char)V;
+      break;
+    }
+    default:
+      break;
+    }
   }
 
   PS.setMARdVal(Res);
@@ -130,68 +134,98 @@ const std::set<std::string> INVALID_EX = {"lbu",  "lhu",   "beq",   "blt",
                                           "jalr", "ecall", "ebreak"};
 
 std::optional<Exception> RIPSimulator::exec(PipelineStates &) {
-  const auto &Inst = PS[STAGES::EX];
+  const DecodedInst &Inst = *PS[STAGES::EX];
   RegVal RdVal = 0;
   RegVal CV = 0;
   RegVal Imm = PS.getDEImmVal();
 
-  std::string Mnemo = Inst->getMnemo();
+  switch (Inst.Op) {
   // I-type
-  if (Mnemo == "addi") {
+  case Opcode::ADDI: {
     // To avoid signed overflow.
     union {
       unsigned un;
       int in;
     } u = {.un = (unsigned)PS.getDERs1Val() + (unsigned)PS.getDEImmVal()};
     RdVal = u.in;
-  } else if (Mnemo == "slti") {
+    break;
+  }
+  case Opcode::SLTI:
     RdVal = PS.getDERs1Val() < PS.getDEImmVal();
-  } else if (Mnemo == "sltiu") {
+    break;
+  case Opcode::SLTIU:
     RdVal = (unsigned)PS.getDERs1Val() < (unsigned)PS.getDEImmVal();
-  } else if (Mnemo == "xori") {
+    break;
+  case Opcode::XORI:
     RdVal = PS.getDERs1Val() ^ PS.getDEImmVal();
-  } else if (Mnemo == "ori") {
+    break;
+  case Opcode::ORI:
     RdVal = PS.getDERs1Val() | PS.getDEImmVal();
-  } else if (Mnemo == "andi") {
+    break;
+  case Opcode::ANDI:
     RdVal = PS.getDERs1Val() & PS.getDEImmVal();
-  } else if (Mnemo == "jalr") {
+    break;
+  case Opcode::JALR: {
     RdVal = PS.getPCs(EX) + 4;
     // FIXME: we can obviously predict those address.
-    Address nextPC = PS.getDERs1Val() + signExtend(PS.getDEImmVal(), 12);
+    Address nextPC = PS.getDERs1Val() + PS.getDEImmVal();
     PS.setBranchPC(nextPC);
     PS.setInvalid(DE);
     PS.setInvalid(IF);
-
-  } else if (Mnemo == "lb" || Mnemo == "lh" || Mnemo == "lw" ||
-             Mnemo == "lbu" || Mnemo == "lhu") {
+    break;
+  }
+  case Opcode::LB:
+  case Opcode::LH:
+  case Opcode::LW:
+  case Opcode::LBU:
+  case Opcode::LHU:
     RdVal = PS.getDERs1Val() + PS.getDEImmVal();
     // FIXME: checking Rs1 checks on this is annoying now.
-    if (PS[STAGES::DE] && Inst->hasRd())
+    if (PS[STAGES::DE] && Inst.hasRd())
       if ((PS[STAGES::DE]->hasRs1() &&
-           Inst->getRd() == PS[STAGES::DE]->getRs1()) ||
+           Inst.Rd == PS[STAGES::DE]->Rs1) ||
           (PS[STAGES::DE]->hasRs2() &&
-           Inst->getRd() == PS[STAGES::DE]->getRs2())) {
+           Inst.Rd == PS[STAGES::DE]->Rs2)) {
         PS.setStall(STAGES::DE);
         PS.setStall(STAGES::IF);
       }
-  } else if (Mnemo == "slli") { // FIXME: shamt
+    break;
+  case Opcode::SLLI: // FIXME: shamt
     RdVal = (unsigned)PS.getDERs1Val() << PS.getDEImmVal();
-  } else if (Mnemo == "srli") {
+    break;
+  case Opcode::SRLI:
     RdVal = (unsigned)PS.getDERs1Val() >> PS.getDEImmVal();
-  } else if (Mnemo == "srai") {
+    break;
+  case Opcode::SRAI:
     RdVal = PS.getDERs1Val() >> PS.getDEImmVal();
-  } else if (Mnemo == "fence" || Mnemo == "fence.i") {
+    break;
+  case Opcode::FENCE:
     // FIXME: currently expected to be nop
-  } else if (Mnemo == "csrrw" || Mnemo == "csrrwi") {
+    break;
+  case Opcode::FENCE_I:
+    // stores before this are done on MA, so drop decoded instructions and
+    // refetch the following ones.
+    DC.flush();
+    PS.setBranchPC(PS.getPCs(EX) + 4);
+    PS.setInvalid(DE);
+    PS.setInvalid(IF);
+    break;
+  case Opcode::CSRRW:
+  case Opcode::CSRRWI:
     CV = PS.getDERs1Val();
     RdVal = PS.getDECSRVal();
-  } else if (Mnemo == "csrrs" || Mnemo == "csrrsi") {
+    break;
+  case Opcode::CSRRS:
+  case Opcode::CSRRSI:
     CV = PS.getDECSRVal() | PS.getDERs1Val();
     RdVal = PS.getDECSRVal();
-  } else if (Mnemo == "csrrc" || Mnemo == "csrrci") {
+    break;
+  case Opcode::CSRRC:
+  case Opcode::CSRRCI:
     CV = PS.getDECSRVal() & ~PS.getDERs1Val();
     RdVal = PS.getDECSRVal();
-  } else if (Mnemo == "ecall") {
+    break;
+  case Opcode::ECALL:
     if (Mode == ModeKind::User) {
       return Exception::EnvironmentCallFromUMode;
     } else if (Mode == ModeKind::Supervisor) {
@@ -202,16 +236,16 @@ std::optional<Exception> RIPSimulator::exec(PipelineStates &) {
       // FIXME: is this illegal inst?
       return Exception::IllegalInstruction;
     }
-  } else if (Mnemo == "ebreak") {
+  case Opcode::EBREAK:
     return Exception::Breakpoint;
-  } else if (Mnemo == "mret") {
+  case Opcode::MRET: {
     // FIXME: state read, multiple state writing (and mode change) happens,
     // how can we divide these into stages?
 
     Address nextPC = States.read(MEPC);
     // FIXME: Forwarding happens on "mret" reading ???
-    if (PS[STAGES::MA] && CSR_INSTs.count(PS[STAGES::MA]->getMnemo()) &&
-        (MEPC == PS[STAGES::MA]->getIImm())) {
+    if (PS[STAGES::MA] && PS[STAGES::MA]->isCSR() &&
+        (MEPC == PS[STAGES::MA]->getCSRAddr())) {
       nextPC = PS.getMACSRVal();
       std::cerr << "Exception: Forwarding MEPC val from MA : "
                 << "\n";
@@ -222,8 +256,8 @@ std::optional<Exception> RIPSimulator::exec(PipelineStates &) {
     // FIXME: add MSTATUS handle methods
     // FIXME: Forwarding happens on "mret" reading ???
     CSRVal MSTATUSVal = States.read(MSTATUS);
-    if (PS[STAGES::MA] && CSR_INSTs.count(PS[STAGES::MA]->getMnemo()) &&
-        (MSTATUS == PS[STAGES::MA]->getIImm())) {
+    if (PS[STAGES::MA] && PS[STAGES::MA]->isCSR() &&
+        (MSTATUS == PS[STAGES::MA]->getCSRAddr())) {
       MSTATUSVal = PS.getMACSRVal();
       std::cerr << "Exception: Forwarding MSTATUS val from MA : "
                 << "\n";
@@ -255,58 +289,76 @@ std::optional<Exception> RIPSimulator::exec(PipelineStates &) {
 
     // Set MPP to 0
     States.setMPP((ModeKind)0);
-
-  } else if (Mnemo == "ext") {
+    break;
+  }
+  case Opcode::EXT:
     return Exception::R0;
-  } else if (Mnemo == "extx") {
+  case Opcode::EXTX:
     return Exception::R1;
-  } else if (Mnemo == "add") { // R-type
+  // R-type
+  case Opcode::ADD: {
     // To avoid signed overflow.
     union {
       unsigned un;
       int in;
     } u = {.un = (unsigned)PS.getDERs1Val() + (unsigned)PS.getDERs2Val()};
     RdVal = u.in;
-  } else if (Mnemo == "sub") {
+    break;
+  }
+  case Opcode::SUB: {
     // To avoid signed overflow.
     union {
       unsigned un;
       int in;
     } u = {.un = (unsigned)PS.getDERs1Val() - (unsigned)PS.getDERs2Val()};
     RdVal = u.in;
-  } else if (Mnemo == "sll") {
+    break;
+  }
+  case Opcode::SLL:
     RdVal = PS.getDERs1Val() << (PS.getDERs2Val() & 0b11111);
-  } else if (Mnemo == "slt") {
+    break;
+  case Opcode::SLT:
     RdVal = PS.getDERs1Val() < PS.getDERs2Val();
-  } else if (Mnemo == "sltu") {
+    break;
+  case Opcode::SLTU:
     RdVal = (unsigned)PS.getDERs1Val() < (unsigned)PS.getDERs2Val();
-  } else if (Mnemo == "xor") {
+    break;
+  case Opcode::XOR:
     RdVal = PS.getDERs1Val() ^ PS.getDERs2Val();
-  } else if (Mnemo == "srl") {
+    break;
+  case Opcode::SRL:
     RdVal = (unsigned)PS.getDERs1Val() >> (PS.getDERs2Val() & 0b11111);
-  } else if (Mnemo == "sra") {
+    break;
+  case Opcode::SRA:
     RdVal = (signed)PS.getDERs1Val() >> (signed)(PS.getDERs2Val() & 0b11111);
-  } else if (Mnemo == "or") {
+    break;
+  case Opcode::OR:
     RdVal = PS.getDERs1Val() | PS.getDERs2Val();
-  } else if (Mnemo == "and") {
+    break;
+  case Opcode::AND:
     RdVal = PS.getDERs1Val() & PS.getDERs2Val();
-  } else if (Mnemo == "mul") {
+    break;
+  case Opcode::MUL:
     RdVal = ((signed long long)PS.getDERs1Val() *
              (signed long long)PS.getDERs2Val()) &
             0xffffffff;
-  } else if (Mnemo == "mulh") {
+    break;
+  case Opcode::MULH:
     RdVal = ((signed long long)PS.getDERs1Val() *
              (signed long long)PS.getDERs2Val()) >>
             32;
-  } else if (Mnemo == "mulhsu") {
+    break;
+  case Opcode::MULHSU:
     RdVal = ((signed long long)PS.getDERs1Val() *
              (unsigned long long)(unsigned int)PS.getDERs2Val()) >>
             32;
-  } else if (Mnemo == "mulhu") {
+    break;
+  case Opcode::MULHU:
     RdVal = ((unsigned long long)(unsigned int)PS.getDERs1Val() *
              (unsigned long long)(unsigned int)PS.getDERs2Val()) >>
             32;
-  } else if (Mnemo == "div") {
+    break;
+  case Opcode::DIV: {
     // FIXME: set DV zero register?
     RegVal Divisor = PS.getDERs2Val(), Dividend = PS.getDERs1Val();
     if (Divisor == 0) {
@@ -317,14 +369,18 @@ std::optional<Exception> RIPSimulator::exec(PipelineStates &) {
     } else {
       RdVal = Dividend / Divisor;
     }
-  } else if (Mnemo == "divu") {
+    break;
+  }
+  case Opcode::DIVU: {
     RegVal Divisor = PS.getDERs2Val(), Dividend = PS.getDERs1Val();
     if (Divisor == 0) {
       RdVal = std::numeric_limits<std::uint32_t>::max();
     } else {
       RdVal = (unsigned int)Dividend / (unsigned int)Divisor;
     }
-  } else if (Mnemo == "rem") {
+    break;
+  }
+  case Opcode::REM: {
     RegVal Divisor = PS.getDERs2Val(), Dividend = PS.getDERs1Val();
     if (Divisor == 0) {
       RdVal = Dividend;
@@ -334,41 +390,55 @@ std::optional<Exception> RIPSimulator::exec(PipelineStates &) {
     } else {
       RdVal = PS.getDERs1Val() % PS.getDERs2Val();
     }
-  } else if (Mnemo == "remu") {
+    break;
+  }
+  case Opcode::REMU: {
     RegVal Divisor = PS.getDERs2Val(), Dividend = PS.getDERs1Val();
     if (Divisor == 0) {
       RdVal = Dividend;
     } else {
       RdVal = (unsigned int)PS.getDERs1Val() % (unsigned int)PS.getDERs2Val();
     }
-
-    // J-type
-  } else if (Mnemo == "jal") {
-
+    break;
+  }
+  // J-type
+  case Opcode::JAL: {
     // FIXME: we can obviously predict those address.
     RdVal = PS.getPCs(EX) + 4;
-    Address nextPC = PS.getPCs(EX) + signExtend(PS.getDEImmVal(), 20);
+    Address nextPC = PS.getPCs(EX) + PS.getDEImmVal();
     PS.setBranchPC(nextPC);
     PS.setInvalid(DE);
     PS.setInvalid(IF);
-
-    // B-type
-  } else if (BTypeKinds.count(Mnemo)) {
-    bool Cond;
-    if (Mnemo == "beq") {
+    break;
+  }
+  // B-type
+  case Opcode::BEQ:
+  case Opcode::BNE:
+  case Opcode::BLT:
+  case Opcode::BGE:
+  case Opcode::BLTU:
+  case Opcode::BGEU: {
+    bool Cond = false;
+    switch (Inst.Op) {
+    case Opcode::BEQ:
       Cond = PS.getDERs1Val() == PS.getDERs2Val();
-
-    } else if (Mnemo == "bne") {
+      break;
+    case Opcode::BNE:
       Cond = PS.getDERs1Val() != PS.getDERs2Val();
-    } else if (Mnemo == "blt") {
+      break;
+    case Opcode::BLT:
       Cond = PS.getDERs1Val() < PS.getDERs2Val();
-    } else if (Mnemo == "bge") {
+      break;
+    case Opcode::BGE:
       Cond = PS.getDERs1Val() >= PS.getDERs2Val();
-    } else if (Mnemo == "bltu") {
+      break;
+    case Opcode::BLTU:
       Cond = (unsigned)PS.getDERs1Val() < (unsigned)PS.getDERs2Val();
-    } else if (Mnemo == "bgeu") {
+      break;
+    case Opcode::BGEU:
       Cond = (unsigned)PS.getDERs1Val() >= (unsigned)PS.getDERs2Val();
-    } else {
+      break;
+    default:
       assert(false && "unreachable!");
     }
 
@@ -406,19 +476,26 @@ std::optional<Exception> RIPSimulator::exec(PipelineStates &) {
       BP->StatsUpdate(Cond, Pred);
       BP->Learn(Cond, PS.getPCs(EX)); // FIXME: How to pass PS
     }
-
-    // S-type
-  } else if (Mnemo == "sb" || Mnemo == "sw" || Mnemo == "sh") {
+    break;
+  }
+  // S-type
+  case Opcode::SB:
+  case Opcode::SW:
+  case Opcode::SH:
     // FIXME: wrap add?
     RdVal = PS.getDERs1Val() + PS.getDEImmVal();
     PS.setEXRs2Val(PS.getDERs2Val());
-    // U-type
-  } else if (Mnemo == "lui") {
+    break;
+  // U-type
+  case Opcode::LUI:
     RdVal = PS.getDEImmVal() << 12;
-  } else if (Mnemo == "auipc") {
+    break;
+  case Opcode::AUIPC:
     RdVal = PS.getPCs(EX) + (PS.getDEImmVal() << 12);
-  } else {
+    break;
+  default:
     assert(false && "unimplemented!");
+    break;
   }
 
   PS.setEXRdVal(RdVal);
@@ -430,63 +507,64 @@ std::optional<Exception> RIPSimulator::exec(PipelineStates &) {
 
 namespace {
 
-static bool forwardRs1OnDE(const std::unique_ptr<Instruction> &Inst,
-                           PipelineStates &PS, GPRegisters &GPRegs) {
+static bool forwardRs1OnDE(const DecodedInst &Inst, PipelineStates &PS,
+                           GPRegisters &GPRegs) {
   if (PS[STAGES::EX] && PS[STAGES::EX]->hasRd() &&
-      Inst->getRs1() == PS[STAGES::EX]->getRd()) {
+      Inst.Rs1 == PS[STAGES::EX]->Rd) {
     // EX forward
     PS.setDERs1Val(PS.getEXRdVal());
-    DEBUG_ONLY(std::cerr << "Forwarding Rs1 from EX: " << Inst->getMnemo()
-                         << "\n");
+    DEBUG_ONLY(std::cerr << "Forwarding Rs1 from EX: "
+                         << getOpcodeInfo(Inst.Op).Mnemo << "\n");
     return true;
   }
   if (PS[STAGES::MA] && PS[STAGES::MA]->hasRd() &&
-      Inst->getRs1() == PS[STAGES::MA]->getRd()) {
+      Inst.Rs1 == PS[STAGES::MA]->Rd) {
     // MA forward
     PS.setDERs1Val(PS.getMARdVal());
-    DEBUG_ONLY(std::cerr << "Forwarding Rs1 from MA: " << Inst->getMnemo()
-                         << "\n");
+    DEBUG_ONLY(std::cerr << "Forwarding Rs1 from MA: "
+                         << getOpcodeInfo(Inst.Op).Mnemo << "\n");
     return true;
   }
   return false;
 }
 
-static bool forwardCSROnDE(const std::unique_ptr<Instruction> &Inst,
-                           PipelineStates &PS, GPRegisters &GPRegs) {
-  if (!CSR_INSTs.count(Inst->getMnemo()))
+static bool forwardCSROnDE(const DecodedInst &Inst, PipelineStates &PS,
+                           GPRegisters &GPRegs) {
+  if (!Inst.isCSR())
     return false;
-  if (PS[STAGES::EX] && CSR_INSTs.count(PS[STAGES::EX]->getMnemo()) &&
-      (Inst->getIImm() == PS[STAGES::EX]->getIImm())) {
+  if (PS[STAGES::EX] && PS[STAGES::EX]->isCSR() &&
+      (Inst.getCSRAddr() == PS[STAGES::EX]->getCSRAddr())) {
 
     PS.setDECSRVal(PS.getEXCSRVal());
-    DEBUG_ONLY(std::cerr << "Forwarding CSR val from EX : " << Inst->getMnemo()
-                         << " " << PS.getEXCSRVal() << "\n");
+    DEBUG_ONLY(std::cerr << "Forwarding CSR val from EX : "
+                         << getOpcodeInfo(Inst.Op).Mnemo << " "
+                         << PS.getEXCSRVal() << "\n");
     return true;
   }
-  if (PS[STAGES::MA] && CSR_INSTs.count(PS[STAGES::MA]->getMnemo()) &&
-      (Inst->getIImm() == PS[STAGES::MA]->getIImm())) {
+  if (PS[STAGES::MA] && PS[STAGES::MA]->isCSR() &&
+      (Inst.getCSRAddr() == PS[STAGES::MA]->getCSRAddr())) {
     PS.setDECSRVal(PS.getMACSRVal());
-    DEBUG_ONLY(std::cerr << "Forwarding CSR val from MA: " << Inst->getMnemo()
-                         << "\n");
+    DEBUG_ONLY(std::cerr << "Forwarding CSR val from MA: "
+                         << getOpcodeInfo(Inst.Op).Mnemo << "\n");
     return true;
   }
   return false;
 }
 
-static bool forwardRs2OnDE(const std::unique_ptr<Instruction> &Inst,
-                           PipelineStates &PS, GPRegisters &GPRegs) {
+static bool forwardRs2OnDE(const DecodedInst &Inst, PipelineStates &PS,
+                           GPRegisters &GPRegs) {
 
   if (PS[STAGES::EX] && PS[STAGES::EX]->hasRd() &&
-      Inst->getRs2() == PS[STAGES::EX]->getRd()) {
+      Inst.Rs2 == PS[STAGES::EX]->Rd) {
     PS.setDERs2Val(PS.getEXRdVal());
-    DEBUG_ONLY(std::cerr << "Forwarding Rs2 from EX: " << Inst->getMnemo()
-                         << "\n");
+    DEBUG_ONLY(std::cerr << "Forwarding Rs2 from EX: "
+                         << getOpcodeInfo(Inst.Op).Mnemo << "\n");
     return true;
   } else if (PS[STAGES::MA] && PS[STAGES::MA]->hasRd() &&
-             Inst->getRs2() == PS[STAGES::MA]->getRd()) {
+             Inst.Rs2 == PS[STAGES::MA]->Rd) {
     PS.setDERs2Val(PS.getMARdVal());
-    DEBUG_ONLY(std::cerr << "Forwarding Rs2 from MA: " << Inst->getMnemo()
-                         << "\n");
+    DEBUG_ONLY(std::cerr << "Forwarding Rs2 from MA: "
+                         << getOpcodeInfo(Inst.Op).Mnemo << "\n");
     return true;
   }
   return false;
@@ -498,50 +576,38 @@ static bool forwardRs2OnDE(const std::unique_ptr<Instruction> &Inst,
 // GPRegs directly.
 void RIPSimulator::decode(GPRegisters &, PipelineStates &) {
   // FIXME: PS indexing seems not consistent(it's not only instructions)
-  const auto &Inst = PS[STAGES::DE];
+  const DecodedInst &Inst = *PS[STAGES::DE];
   int Imm = 0;
 
   // Register access on Rs1
   // FIXME: we can forward if EX or MA is also immediate CSR instructions.
-  if (Inst->getMnemo() == "csrrwi" || Inst->getMnemo() == "csrrsi" ||
-      Inst->getMnemo() == "csrrci") {
-    PS.setDERs1Val((unsigned int)Inst->getRs1());
-  } else if (Inst->hasRs1() && !forwardRs1OnDE(Inst, PS, GPRegs)) {
-    PS.setDERs1Val(GPRegs[Inst->getRs1()]);
+  if (Inst.isCSRImm()) {
+    PS.setDERs1Val((unsigned int)Inst.Rs1);
+  } else if (Inst.hasRs1() && !forwardRs1OnDE(Inst, PS, GPRegs)) {
+    PS.setDERs1Val(GPRegs[Inst.Rs1]);
   }
 
   // Register access on CSR
-  if (CSR_INSTs.count(Inst->getMnemo()) && !forwardCSROnDE(Inst, PS, GPRegs)) {
-    PS.setDECSRVal(States[Inst->getIImm()]);
+  if (Inst.isCSR() && !forwardCSROnDE(Inst, PS, GPRegs)) {
+    PS.setDECSRVal(States[Inst.getCSRAddr()]);
   }
 
   // Register access on Rs2
-  if (Inst->hasRs2() && !forwardRs2OnDE(Inst, PS, GPRegs)) {
-    PS.setDERs2Val(GPRegs[Inst->getRs2()]);
+  if (Inst.hasRs2() && !forwardRs2OnDE(Inst, PS, GPRegs)) {
+    PS.setDERs2Val(GPRegs[Inst.Rs2]);
   }
 
-  // Decode immediate value
-  if (ITypeKinds.count(Inst->getMnemo())) {
-    Imm = signExtend(Inst->getIImm(), 12);
-  } else if (STypeKinds.count(Inst->getMnemo())) {
-    Imm = signExtend(Inst->getSImm(), 12);
-  } else if (JTypeKinds.count(Inst->getMnemo())) {
-    Imm = signExtend(Inst->getJImm(), 20);
-  } else if (BTypeKinds.count(Inst->getMnemo())) {
-    Imm = signExtend(Inst->getBImm(), 13);
+  // Immediate value is already sign extended on decoding.
+  Imm = Inst.Imm;
+  if (Inst.isBranch() && BP) {
+    bool pred = BP->Predict(PS.getPCs(DE));
+    BP->setPrevPred(pred);
 
-    if (BP) {
-      bool pred = BP->Predict(PS.getPCs(DE));
-      BP->setPrevPred(pred);
-
-      if (pred) {
-        BP->setBranchPredPC(PS.getPCs(DE) + Imm);
-        PS.setInvalid(IF);
-      }
-      DEBUG_ONLY(std::cerr << std::hex << "Branch Pred: " << pred << "\n";);
+    if (pred) {
+      BP->setBranchPredPC(PS.getPCs(DE) + Imm);
+      PS.setInvalid(IF);
     }
-  } else if (UTypeKinds.count(Inst->getMnemo())) {
-    Imm = signExtend(Inst->getUImm(), 20);
+    DEBUG_ONLY(std::cerr << std::hex << "Branch Pred: " << pred << "\n";);
   }
   PS.setDEImmVal(Imm);
   // TODO: stall 1 cycle if the inst is load;
@@ -571,13 +637,13 @@ bool RIPSimulator::handleException(Exception &E) {
   if (Mode == ModeKind::Machine) {
     CSRVal VecVal = States.read(MTVEC);
     // FIXME: Forwarding happens on exception handling?
-    if (PS[STAGES::EX] && CSR_INSTs.count(PS[STAGES::EX]->getMnemo()) &&
-        (MTVEC == PS[STAGES::EX]->getIImm())) {
+    if (PS[STAGES::EX] && PS[STAGES::EX]->isCSR() &&
+        (MTVEC == PS[STAGES::EX]->getCSRAddr())) {
       VecVal = PS.getEXCSRVal();
       std::cerr << "Exception: Forwarding MTVEC val from EX : "
                 << "\n";
-    } else if (PS[STAGES::MA] && CSR_INSTs.count(PS[STAGES::MA]->getMnemo()) &&
-               (MTVEC == PS[STAGES::MA]->getIImm())) {
+    } else if (PS[STAGES::MA] && PS[STAGES::MA]->isCSR() &&
+               (MTVEC == PS[STAGES::MA]->getCSRAddr())) {
       VecVal = PS.getMACSRVal();
       std::cerr << "Exception: Forwarding MTVEC val from MA : "
                 << "\n";
@@ -590,7 +656,7 @@ bool RIPSimulator::handleException(Exception &E) {
     States.write(MCAUSE, Cause);
 
     // Machine Trap Value Register
-    States.write(MTVAL, trap_val(E, ExceptionPC, PS[STAGES::EX]->getVal()));
+    States.write(MTVAL, trap_val(E, ExceptionPC, PS[STAGES::EX]->Val));
 
     // set MPIE to MIE;
     // MIE: Global Interrupt-Enable bit for machine mode. 3-th bit of
@@ -599,13 +665,13 @@ bool RIPSimulator::handleException(Exception &E) {
 
     // FIXME: Forwarding happens on exception handling?
     CSRVal MSTATUSVal = States.read(MSTATUS);
-    if (PS[STAGES::EX] && CSR_INSTs.count(PS[STAGES::EX]->getMnemo()) &&
-        (MSTATUS == PS[STAGES::EX]->getIImm())) {
+    if (PS[STAGES::EX] && PS[STAGES::EX]->isCSR() &&
+        (MSTATUS == PS[STAGES::EX]->getCSRAddr())) {
       MSTATUSVal = PS.getEXCSRVal();
       std::cerr << "Exception: Forwarding MSTATUS val from EX : "
                 << "\n";
-    } else if (PS[STAGES::MA] && CSR_INSTs.count(PS[STAGES::MA]->getMnemo()) &&
-               (MSTATUS == PS[STAGES::MA]->getIImm())) {
+    } else if (PS[STAGES::MA] && PS[STAGES::MA]->isCSR() &&
+               (MSTATUS == PS[STAGES::MA]->getCSRAddr())) {
       MSTATUSVal = PS.getMACSRVal();
       std::cerr << "Exception: Forwarding MSTATUS val from MA : "
                 << "\n";
@@ -656,14 +722,14 @@ bool RIPSimulator::proceedNStage(unsigned N) {
       PS.proceed(nullptr);
       PS.clearStall();
     } else {
-      auto InstPtr = Dec.decode(Mem.readWord(PC));
+      auto InstPtr = DC.fetch(PC);
       PS.proceedPC(PC);
       // FIXME: this should inherently be moved the following update of PC, but
       // some stages refers PC and moving this to latter would break.
       if (InstPtr) {
         PC += 4;
       }
-      PS.proceed(std::move(InstPtr));
+      PS.proceed(InstPtr ? &InstPtr->getDecoded() : nullptr);
     }
 
     // exit if pipeline is empty.
@@ -712,10 +778,9 @@ bool RIPSimulator::proceedNStage(unsigned N) {
 
     // Statistics calculation
     if (Stats) {
-      if (auto &EXInst = PS[STAGES::EX]) {
-        std::string Mnemo = EXInst->getMnemo();
-        Stats->addInst(Mnemo);
-        if (BTypeKinds.count(Mnemo))
+      if (const DecodedInst *EXInst = PS[STAGES::EX]) {
+        Stats->addInst(getOpcodeInfo(EXInst->Op).Mnemo);
+        if (EXInst->isBranch())
           Stats->addBDistAndReset();
         else
           Stats->incrementBDist();
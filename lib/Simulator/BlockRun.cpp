@@ -0,0 +1,118 @@
+// Basic block execution engine of Simulator.
+//
+// Instructions are executed block by block from BlockCache, and the next
+// block is taken from the links of the current one, so the cache is looked
+// up only on indirect jumps and the first visit of an edge. System
+// instructions (csr*, ecall, mret, fence.i, ...) end a block and go through
+// Simulator::step(), so their semantics are shared with run(). With a JIT,
+// blocks executed more than JITThreshold times run as host code.
+#include "Simulator/Simulator.h"
+
+namespace {
+
+/// branch distances shorter than this are counted locally.
+const unsigned NUM_LOCAL_BDISTS = 256;
+
+} // namespace
+
+void Simulator::runBlocks(std::optional<Address> StartAddress,
+                          std::optional<Address> EndAddress) {
+  if (StartAddress)
+    PC = *StartAddress;
+  runBlockLoop(EndAddress, nullptr);
+}
+
+void Simulator::runJIT(std::optional<Address> StartAddress,
+                       std::optional<Address> EndAddress) {
+  if (StartAddress)
+    PC = *StartAddress;
+  if (!JIT)
+    JIT = std::make_unique<JITCompiler>();
+  runBlockLoop(EndAddress, JIT.get());
+}
+
+void Simulator::runBlockLoop(std::optional<Address> EndAddress,
+                             JITCompiler *Compiler) {
+  BC.setStopAddress(EndAddress);
+  JITContext Ctx = {&GPRegs, &Mem, &States, &Mode, nullptr};
+
+  // statistics, flushed to Stats on leaving the loop.
+  std::uint64_t Counts[NUM_OPCODES] = {};
+  std::uint64_t BDistCounts[NUM_LOCAL_BDISTS] = {};
+  unsigned Dist = Stats.getBDist();
+  auto Count = [&](const DecodedInst &DI) {
+    ++Counts[static_cast<unsigned>(DI.Op)];
+    if (DI.isBranch()) {
+      if (Dist < NUM_LOCAL_BDISTS)
+        ++BDistCounts[Dist];
+      else
+        Stats.addBDist(Dist);
+      Dist = 0;
+    } else {
+      ++Dist;
+    }
+  };
+
+  BasicBlock *B = BC.lookup(PC);
+  while (B) {
+    if (EndAddress && PC == *EndAddress) {
+      std::cerr << "PC reached EndAddress = 0x" << std::hex << *EndAddress
+                << "\n";
+      break;
+    }
+    ++B->ExecCount;
+    bool Stop = false;
+    unsigned I = 0;
+    if (Compiler && !B->HostCode && B->ExecCount > JITThreshold)
+      B->HostCode = reinterpret_cast<void *>(Compiler->compile(*B));
+    if (B->HostCode) {
+      // host code stops before a system instruction, or after a store
+      // overwriting the block.
+      Ctx.Block = B;
+      JITResult R = reinterpret_cast<JITFunction>(B->HostCode)(GPRegs.data(),
+                                                               &Ctx);
+      PC = R.NextPC;
+      for (; I < R.Executed; ++I)
+        Count(B->Insts[I]);
+    }
+    unsigned Executed = I;
+    for (; I < B->Insts.size(); ++I) {
+      // the rest of the block is overwritten by the last store.
+      if (!B->Valid)
+        break;
+      const DecodedInst &DI = B->Insts[I];
+      if (isSystem(DI.Op)) {
+        // step() counts the instruction itself.
+        States.write(CYCLE, States.read(CYCLE) + Executed);
+        Executed = 0;
+        Stats.setBDist(Dist);
+        Stop = !step(DI);
+        Dist = Stats.getBDist();
+        break;
+      }
+      exec(DI, PC, GPRegs, Mem, States, Mode);
+      Count(DI);
+      ++Executed;
+    }
+    States.write(CYCLE, States.read(CYCLE) + Executed);
+    if (Stop)
+      break;
+    // reclaim the code buffer, the running block is retired but alive.
+    if (Compiler && Compiler->isFull()) {
+      BC.flush();
+      Compiler->reset();
+    }
+    B = BC.next(B, PC);
+    BC.collect();
+  }
+
+  Stats.setBDist(Dist);
+  for (unsigned i = 0; i < NUM_OPCODES; ++i)
+    if (Counts[i])
+      Stats.addInst(OpcodeInfos[i].Mnemo, Counts[i]);
+  for (unsigned i = 0; i < NUM_LOCAL_BDISTS; ++i)
+    if (BDistCounts[i])
+      Stats.addBDist(i, BDistCounts[i]);
+  BC.collect();
+  dumpStats();
+}
@@ -0,0 +1,520 @@
+// x86-64 code generation for basic blocks of Simulator.
+//
+// Guest registers stay in GPRegisters and are addressed as [rbx + 4 * i],
+// rbx holds the register file and r12 holds JITContext during a block. ALU,
+// branch and jump semantics follow exec() of lib/Instructions.cpp. Loads and
+// stores call helpers using the Memory fast path, division calls exec().
+#include "Simulator/JIT.h"
+#include "Instructions.h"
+#include <cstring>
+#include <initializer_list>
+#include <iostream>
+#include <vector>
+#if SIMULATOR_HAS_JIT
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+#if SIMULATOR_HAS_JIT
+
+enum X86Reg : std::uint8_t {
+  RAX = 0,
+  RCX = 1,
+  RDX = 2,
+  RBX = 3,
+  RSI = 6,
+  RDI = 7,
+};
+
+/// condition codes of jcc and setcc.
+enum X86Cond : std::uint8_t {
+  CC_B = 0x2,
+  CC_AE = 0x3,
+  CC_E = 0x4,
+  CC_NE = 0x5,
+  CC_L = 0xc,
+  CC_GE = 0xd,
+};
+
+/// /digit of the group 1 (81 /digit) and group 2 (c1, d3 /digit) opcodes.
+enum X86Digit : std::uint8_t {
+  ADD = 0,
+  OR = 1,
+  AND = 4,
+  SHL = 4,
+  SHR = 5,
+  XOR = 6,
+  CMP = 7,
+  SAR = 7,
+};
+
+/// Encoder for the few x86-64 instructions the JIT uses. Operations work on
+/// eax (and ecx as the second operand) unless noted.
+class X86Emitter {
+  std::vector<Byte> Buf;
+
+  static Byte modrm(unsigned Mod, unsigned Reg, unsigned RM) {
+    return (Mod << 6) | ((Reg & 7) << 3) | (RM & 7);
+  }
+
+public:
+  const std::vector<Byte> &getBuffer() const { return Buf; }
+  std::size_t size() const { return Buf.size(); }
+
+  void bytes(std::initializer_list<Byte> Bs) {
+    Buf.insert(Buf.end(), Bs.begin(), Bs.end());
+  }
+  void imm32(std::uint32_t V) {
+    for (unsigned i = 0; i < 4; ++i)
+      Buf.push_back(V >> (8 * i));
+  }
+  void imm64(std::uint64_t V) {
+    for (unsigned i = 0; i < 8; ++i)
+      Buf.push_back(V >> (8 * i));
+  }
+
+  // push rbx; push r12; sub rsp, 8; mov rbx, rdi; mov r12, rsi
+  void prologue() {
+    bytes({0x53, 0x41, 0x54, 0x48, 0x83, 0xec, 0x08});
+    bytes({0x48, 0x89, 0xfb, 0x49, 0x89, 0xf4});
+  }
+  // add rsp, 8; pop r12; pop rbx; ret
+  void epilogue() { bytes({0x48, 0x83, 0xc4, 0x08, 0x41, 0x5c, 0x5b, 0xc3}); }
+
+  /// mov R32, [rbx + 4 * Guest]
+  void loadGuest(X86Reg R, unsigned Guest) {
+    bytes({0x8b, modrm(2, R, RBX)});
+    imm32(4 * Guest);
+  }
+  /// movsxd R64, [rbx + 4 * Guest]
+  void loadGuestSExt(X86Reg R, unsigned Guest) {
+    bytes({0x48, 0x63, modrm(2, R, RBX)});
+    imm32(4 * Guest);
+  }
+  /// mov [rbx + 4 * Guest], eax
+  void storeGuest(unsigned Guest) {
+    bytes({0x89, modrm(2, RAX, RBX)});
+    imm32(4 * Guest);
+  }
+  /// mov dword [rbx + 4 * Guest], V
+  void storeGuestImm(unsigned Guest, std::uint32_t V) {
+    bytes({0xc7, modrm(2, 0, RBX)});
+    imm32(4 * Guest);
+    imm32(V);
+  }
+  /// mov R32, V (zero extended to R64)
+  void movImm32(X86Reg R, std::uint32_t V) {
+    bytes({static_cast<Byte>(0xb8 + R)});
+    imm32(V);
+  }
+  /// mov R64, V
+  void movImm64(X86Reg R, std::uint64_t V) {
+    bytes({0x48, static_cast<Byte>(0xb8 + R)});
+    imm64(V);
+  }
+  /// <Digit> eax, V
+  void aluImm(X86Digit Digit, std::uint32_t V) {
+    bytes({0x81, modrm(3, Digit, RAX)});
+    imm32(V);
+  }
+  /// <Opc> eax, ecx where Opc is the "r/m32, r32" form.
+  void aluRR(Byte Opc) { bytes({Opc, modrm(3, RCX, RAX)}); }
+  void cmpRR() { aluRR(0x39); }
+  void testRR() { bytes({0x85, modrm(3, RAX, RAX)}); }
+  /// <Digit> eax, Amount
+  void shiftImm(X86Digit Digit, Byte Amount) {
+    bytes({0xc1, modrm(3, Digit, RAX), Amount});
+  }
+  /// <Digit> eax, cl
+  void shiftCL(X86Digit Digit) { bytes({0xd3, modrm(3, Digit, RAX)}); }
+  /// <Digit> rax, Amount
+  void shift64Imm(X86Digit Digit, Byte Amount) {
+    bytes({0x48, 0xc1, modrm(3, Digit, RAX), Amount});
+  }
+  /// imul eax, ecx
+  void imul32() { bytes({0x0f, 0xaf, modrm(3, RAX, RCX)}); }
+  /// imul rax, rcx
+  void imul64() { bytes({0x48, 0x0f, 0xaf, modrm(3, RAX, RCX)}); }
+  /// setcc al; movzx eax, al
+  void setcc(X86Cond CC) {
+    bytes({0x0f, static_cast<Byte>(0x90 | CC), modrm(3, 0, RAX)});
+    bytes({0x0f, 0xb6, modrm(3, RAX, RAX)});
+  }
+  /// movsxd R64, eax
+  void sextEAX(X86Reg R) { bytes({0x48, 0x63, modrm(3, R, RAX)}); }
+  /// mov rdi, r12
+  void movContextToRDI() { bytes({0x4c, 0x89, 0xe7}); }
+  /// call Fn through rax
+  void call(const void *Fn) {
+    movImm64(RAX, reinterpret_cast<std::uint64_t>(Fn));
+    bytes({0xff, modrm(3, 2, RAX)});
+  }
+  /// jcc rel32, returns the position of rel32 for patch().
+  std::size_t jcc(X86Cond CC) {
+    bytes({0x0f, static_cast<Byte>(0x80 | CC)});
+    std::size_t At = size();
+    imm32(0);
+    return At;
+  }
+  /// make rel32 at At jump to the current position.
+  void patch(std::size_t At) {
+    std::uint32_t Rel = size() - (At + 4);
+    std::memcpy(&Buf[At], &Rel, sizeof(Rel));
+  }
+
+  /// return {NextPC, Executed}.
+  void exit(Address NextPC, unsigned Executed) {
+    movImm64(RAX, NextPC);
+    exitRAX(Executed);
+  }
+  /// return {rax, Executed}.
+  void exitRAX(unsigned Executed) {
+    movImm32(RDX, Executed);
+    epilogue();
+  }
+};
+
+// Helpers called by compiled code.
+
+template <typename T, typename S>
+RegVal jitLoad(JITContext *Ctx, Address Ad) {
+  return static_cast<S>(Ctx->Mem->read<T>(Ad));
+}
+
+/// returns non-zero if the running block is overwritten.
+template <typename T>
+int jitStore(JITContext *Ctx, Address Ad, RegVal Val) {
+  if ((unsigned)Ad == 0x10000000) { // picorv32 Dhrystone MMIO
+    std::cerr << (char)Val;
+  } else if (*Ctx->Mode == ModeKind::Epilogue) {
+    std::cerr << "Epilogue:" << Val << "is written to " << Ad << '\n';
+  } else {
+    Ctx->Mem->write<T>(Ad, Val);
+  }
+  return !Ctx->Block->Valid;
+}
+
+void jitExec(JITContext *Ctx, const DecodedInst *DI) {
+  Address PC = 0;
+  exec(*DI, PC, *Ctx->GPRegs, *Ctx->Mem, *Ctx->States, *Ctx->Mode);
+}
+
+const void *getLoadHelper(Opcode Op) {
+  switch (Op) {
+  case Opcode::LB:
+    return reinterpret_cast<const void *>(&jitLoad<Byte, signed char>);
+  case Opcode::LH:
+    return reinterpret_cast<const void *>(&jitLoad<HalfWord, signed short>);
+  case Opcode::LW:
+    return reinterpret_cast<const void *>(&jitLoad<Word, signed>);
+  case Opcode::LBU:
+    return reinterpret_cast<const void *>(&jitLoad<Byte, unsigned char>);
+  case Opcode::LHU:
+    return reinterpret_cast<const void *>(
+        &jitLoad<HalfWord, unsigned short>);
+  default:
+    assert(false && "not a load");
+    return nullptr;
+  }
+}
+
+const void *getStoreHelper(Opcode Op) {
+  switch (Op) {
+  case Opcode::SB:
+    return reinterpret_cast<const void *>(&jitStore<Byte>);
+  case Opcode::SH:
+    return reinterpret_cast<const void *>(&jitStore<HalfWord>);
+  case Opcode::SW:
+    return reinterpret_cast<const void *>(&jitStore<Word>);
+  default:
+    assert(false && "not a store");
+    return nullptr;
+  }
+}
+
+X86Cond getBranchCond(Opcode Op) {
+  switch (Op) {
+  case Opcode::BEQ:
+    return CC_E;
+  case Opcode::BNE:
+    return CC_NE;
+  case Opcode::BLT:
+    return CC_L;
+  case Opcode::BGE:
+    return CC_GE;
+  case Opcode::BLTU:
+    return CC_B;
+  case Opcode::BGEU:
+    return CC_AE;
+  default:
+    assert(false && "not a branch");
+    return CC_E;
+  }
+}
+
+/// emit DI on PC, the I-th instruction of the block. returns false if the
+/// block ends on it.
+bool emitInst(X86Emitter &E, const DecodedInst &DI, Address PC, unsigned I) {
+  switch (DI.Op) {
+  // I-type
+  case Opcode::ADDI:
+  case Opcode::SLTI:
+  case Opcode::SLTIU:
+  case Opcode::XORI:
+  case Opcode::ORI:
+  case Opcode::ANDI:
+  case Opcode::SLLI:
+  case Opcode::SRLI:
+  case Opcode::SRAI: {
+    if (DI.Rd == 0)
+      return true;
+    E.loadGuest(RAX, DI.Rs1);
+    std::uint32_t Imm = DI.Imm;
+    switch (DI.Op) {
+    case Opcode::ADDI:
+      E.aluImm(ADD, Imm);
+      break;
+    case Opcode::SLTI:
+      E.aluImm(CMP, Imm);
+      E.setcc(CC_L);
+      break;
+    case Opcode::SLTIU:
+      E.aluImm(CMP, Imm);
+      E.setcc(CC_B);
+      break;
+    case Opcode::XORI:
+      E.aluImm(XOR, Imm);
+      break;
+    case Opcode::ORI:
+      E.aluImm(OR, Imm);
+      break;
+    case Opcode::ANDI:
+      E.aluImm(AND, Imm);
+      break;
+    case Opcode::SLLI:
+      E.shiftImm(SHL, Imm & 0b11111);
+      break;
+    case Opcode::SRLI:
+      E.shiftImm(SHR, Imm & 0b11111);
+      break;
+    default:
+      E.shiftImm(SAR, Imm & 0b11111);
+      break;
+    }
+    E.storeGuest(DI.Rd);
+    return true;
+  }
+  case Opcode::JALR:
+    E.loadGuest(RAX, DI.Rs1);
+    E.aluImm(ADD, DI.Imm);
+    E.aluImm(AND, ~1u);
+    // the target is sign extended to Address as exec() does.
+    E.sextEAX(RAX);
+    if (DI.Rd != 0)
+      E.storeGuestImm(DI.Rd, PC + 4);
+    E.exitRAX(I + 1);
+    return false;
+  case Opcode::LB:
+  case Opcode::LH:
+  case Opcode::LW:
+  case Opcode::LBU:
+  case Opcode::LHU:
+    E.loadGuest(RAX, DI.Rs1);
+    E.aluImm(ADD, DI.Imm);
+    E.sextEAX(RSI);
+    E.movContextToRDI();
+    E.call(getLoadHelper(DI.Op));
+    if (DI.Rd != 0)
+      E.storeGuest(DI.Rd);
+    return true;
+  case Opcode::FENCE:
+    return true;
+  // S-type
+  case Opcode::SB:
+  case Opcode::SH:
+  case Opcode::SW: {
+    E.loadGuest(RAX, DI.Rs1);
+    E.aluImm(ADD, DI.Imm);
+    E.sextEAX(RSI);
+    E.loadGuest(RDX, DI.Rs2);
+    E.movContextToRDI();
+    E.call(getStoreHelper(DI.Op));
+    // stop if the rest of the block is overwritten.
+    E.testRR();
+    std::size_t Continue = E.jcc(CC_E);
+    E.exit(PC + 4, I + 1);
+    E.patch(Continue);
+    return true;
+  }
+  // B-type
+  case Opcode::BEQ:
+  case Opcode::BNE:
+  case Opcode::BLT:
+  case Opcode::BGE:
+  case Opcode::BLTU:
+  case Opcode::BGEU: {
+    E.loadGuest(RAX, DI.Rs1);
+    E.loadGuest(RCX, DI.Rs2);
+    E.cmpRR();
+    std::size_t Taken = E.jcc(getBranchCond(DI.Op));
+    E.exit(PC + 4, I + 1);
+    E.patch(Taken);
+    E.exit(PC + DI.Imm, I + 1);
+    return false;
+  }
+  // R-type
+  case Opcode::ADD:
+  case Opcode::SUB:
+  case Opcode::SLL:
+  case Opcode::SLT:
+  case Opcode::SLTU:
+  case Opcode::XOR:
+  case Opcode::SRL:
+  case Opcode::SRA:
+  case Opcode::OR:
+  case Opcode::AND:
+  case Opcode::MUL:
+    if (DI.Rd == 0)
+      return true;
+    E.loadGuest(RAX, DI.Rs1);
+    E.loadGuest(RCX, DI.Rs2);
+    switch (DI.Op) {
+    case Opcode::ADD:
+      E.aluRR(0x01);
+      break;
+    case Opcode::SUB:
+      E.aluRR(0x29);
+      break;
+    case Opcode::SLL:
+      E.shiftCL(SHL);
+      break;
+    case Opcode::SLT:
+      E.cmpRR();
+      E.setcc(CC_L);
+      break;
+    case Opcode::SLTU:
+      E.cmpRR();
+      E.setcc(CC_B);
+      break;
+    case Opcode::XOR:
+      E.aluRR(0x31);
+      break;
+    case Opcode::SRL:
+      E.shiftCL(SHR);
+      break;
+    case Opcode::SRA:
+      E.shiftCL(SAR);
+      break;
+    case Opcode::OR:
+      E.aluRR(0x09);
+      break;
+    case Opcode::AND:
+      E.aluRR(0x21);
+      break;
+    default:
+      E.imul32();
+      break;
+    }
+    E.storeGuest(DI.Rd);
+    return true;
+  // the upper halves of 64 bit products.
+  case Opcode::MULH:
+  case Opcode::MULHSU:
+  case Opcode::MULHU:
+    if (DI.Rd == 0)
+      return true;
+    if (DI.Op == Opcode::MULHU)
+      E.loadGuest(RAX, DI.Rs1);
+    else
+      E.loadGuestSExt(RAX, DI.Rs1);
+    if (DI.Op == Opcode::MULH)
+      E.loadGuestSExt(RCX, DI.Rs2);
+    else
+      E.loadGuest(RCX, DI.Rs2);
+    E.imul64();
+    E.shift64Imm(SHR, 32);
+    E.storeGuest(DI.Rd);
+    return true;
+  case Opcode::DIV:
+  case Opcode::DIVU:
+  case Opcode::REM:
+  case Opcode::REMU:
+    E.movContextToRDI();
+    E.movImm64(RSI, reinterpret_cast<std::uint64_t>(&DI));
+    E.call(reinterpret_cast<const void *>(&jitExec));
+    return true;
+  // U-type
+  case Opcode::LUI:
+    if (DI.Rd != 0)
+      E.storeGuestImm(DI.Rd, DI.Imm << 12);
+    return true;
+  case Opcode::AUIPC:
+    if (DI.Rd != 0)
+      E.storeGuestImm(DI.Rd, PC + (DI.Imm << 12));
+    return true;
+  // J-type
+  case Opcode::JAL:
+    if (DI.Rd != 0)
+      E.storeGuestImm(DI.Rd, PC + 4);
+    E.exit(PC + DI.Imm, I + 1);
+    return false;
+  default:
+    // system instructions are left to the interpreter.
+    E.exit(PC, I);
+    return false;
+  }
+}
+
+#endif
+
+/// upper bound of the code size of a block.
+constexpr std::size_t MaxBlockCodeSize = BlockCache::MaxBlockInsts * 96 + 64;
+
+} // namespace
+
+JITCompiler::JITCompiler(std::size_t Capacity) {
+#if SIMULATOR_HAS_JIT
+  void *P = mmap(nullptr, Capacity, PROT_READ | PROT_WRITE | PROT_EXEC,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (P != MAP_FAILED) {
+    Code = static_cast<Byte *>(P);
+    this->Capacity = Capacity;
+  }
+#endif
+}
+
+JITCompiler::~JITCompiler() {
+#if SIMULATOR_HAS_JIT
+  if (Code)
+    munmap(Code, Capacity);
+#endif
+}
+
+bool JITCompiler::isFull() const {
+  return Capacity - Used < MaxBlockCodeSize;
+}
+
+JITFunction JITCompiler::compile(const BasicBlock &B) {
+#if SIMULATOR_HAS_JIT
+  if (!Code || isFull())
+    return nullptr;
+  X86Emitter E;
+  E.prologue();
+  Address PC = B.EntryPC;
+  bool Ended = false;
+  for (unsigned I = 0; I < B.Insts.size() && !Ended; ++I, PC += 4)
+    Ended = !emitInst(E, B.Insts[I], PC, I);
+  if (!Ended)
+    E.exit(PC, B.Insts.size());
+  assert(E.size() <= MaxBlockCodeSize && "block code is too large");
+
+  Byte *Fn = Code + Used;
+  std::memcpy(Fn, E.getBuffer().data(), E.size());
+  // keep entries 16 byte aligned.
+  Used += (E.size() + 15) & ~std::size_t(15);
+  return reinterpret_cast<JITFunction>(Fn);
+#else
+  return nullptr;
+#endif
+}
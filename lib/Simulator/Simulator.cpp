@@ -3,8 +3,9 @@
 #include "Debug.h"
 
 Simulator::Simulator(std::istream &is, Address DRAMSize, Address DRAMBase,
-                     std::optional<Address> SPIValue)
-    : Mem(DRAMSize, DRAMBase), PC(DRAMBase), Mode(ModeKind::Machine),
+                     std::optional<Address> SPIValue, MemoryKind MemKind)
+    : Mem(DRAMSize, DRAMBase, MemKind), DC(Mem, Dec), BC(Mem), CodeSize(0),
+      PC(DRAMBase), Mode(ModeKind::Machine),
       GPRegs(DRAMSize, DRAMBase, SPIValue) {
   // TODO: parse per 2 bytes for compressed instructions
   char Buff[4];
@@ -22,7 +23,7 @@ Simulator::Simulator(std::istream &is, Address DRAMSize, Address DRAMBase,
 
 void Simulator::run(std::optional<Address> StartAddress,
                     std::optional<Address> EndAddress) {
-  while (auto I = Dec.decode(Mem.readWord(PC))) {
+  while (auto I = DC.fetch(PC)) {
     DEBUG_ONLY(std::cerr << "Inst @ 0x" << std::hex << PC << std::dec << ":\n";
                I->pprint(std::cerr););
     if (EndAddress && PC == *EndAddress) {
@@ -30,65 +31,74 @@ void Simulator::run(std::optional<Address> StartAddress,
                 << "\n";
       break;
     }
-    // TODO: non-machine mode
-    if (auto E = I->exec(PC, GPRegs, Mem, States, Mode)) {
-      if (E == Exception::R0) {
-        std::cerr << "ext called\n";
-        break;
-      } else if (E == Exception::R1) {
-        std::cerr << "extx called\n";
-        Mode = ModeKind::Epilogue;
-        continue;
-      }
-      // FIXME: if ecall happens, next address is written, is this correct?
-      Address ExceptionPC = PC;
-      ModeKind PrevMode = Mode;
-      unsigned Cause = *E;
-      // FIXME: temporary exit with break
-      if (E == Exception::Breakpoint) {
-        std::cerr << "breaked\n";
-        break;
-      }
-      if (Mode == ModeKind::Machine) {
-        PC = States.read(MTVEC) & (~1);
+    if (!step(I->getDecoded()))
+      break;
+    DEBUG_ONLY(std::cerr << "Regs after:\n"; dumpGPRegs(); States.dump());
+  }
+  DEBUG_ONLY(std::cerr << "finish with:\n"; dumpGPRegs();
+             std::cerr << "stop on no instruction address="
+                       << "0x" << std::hex << PC << "\n";);
+  dumpStats();
+}
 
-        States.write(MEPC, ExceptionPC & (~1));
+bool Simulator::step(const DecodedInst &DI) {
+  // TODO: non-machine mode
+  if (auto E = exec(DI, PC, GPRegs, Mem, States, Mode)) {
+    if (E == Exception::R0) {
+      std::cerr << "ext called\n";
+      return false;
+    } else if (E == Exception::R1) {
+      std::cerr << "extx called\n";
+      Mode = ModeKind::Epilogue;
+      return true;
+    }
+    // FIXME: if ecall happens, next address is written, is this correct?
+    Address ExceptionPC = PC;
+    ModeKind PrevMode = Mode;
+    unsigned Cause = *E;
+    // FIXME: temporary exit with break
+    if (E == Exception::Breakpoint) {
+      std::cerr << "breaked\n";
+      return false;
+    }
+    if (Mode == ModeKind::Machine) {
+      PC = States.read(MTVEC) & (~1);
+
+      States.write(MEPC, ExceptionPC & (~1));
 
-        States.write(MCAUSE, Cause);
+      States.write(MCAUSE, Cause);
 
-        // Machine Trap Value Register
-        States.write(MTVAL, trap_val(*E, ExceptionPC, I->getVal()));
+      // Machine Trap Value Register
+      States.write(MTVAL, trap_val(*E, ExceptionPC, DI.Val));
 
-        // set MPIE to MIE;
-        // MIE: Global Interrupt-Enable bit for machine mode. 3-th bit of
-        // MSTATUS MPIE: Previous Interrupt-Enable bit for machine mode. 7-th
-        // bit of MSTATUS
-        CSRVal MSTATUSVal = States.read(MSTATUS);
-        bool MIE = (bool)((MSTATUSVal >> 3) & 1);
-        States.write(MSTATUS, (MSTATUSVal & 0xffffff7f) | (MIE << 7));
+      // set MPIE to MIE;
+      // MIE: Global Interrupt-Enable bit for machine mode. 3-th bit of
+      // MSTATUS MPIE: Previous Interrupt-Enable bit for machine mode. 7-th
+      // bit of MSTATUS
+      CSRVal MSTATUSVal = States.read(MSTATUS);
+      bool MIE = (bool)((MSTATUSVal >> 3) & 1);
+      States.write(MSTATUS, (MSTATUSVal & 0xffffff7f) | (MIE << 7));
 
-        // Set MIE to 0
-        States.write(MSTATUS, MSTATUSVal & 0xfffffff7);
+      // Set MIE to 0
+      States.write(MSTATUS, MSTATUSVal & 0xfffffff7);
 
-        // set MPP to prev mode
-        States.write(MSTATUS, (MSTATUSVal & 0xffffe7ff) | (PrevMode << 11));
+      // set MPP to prev mode
+      States.write(MSTATUS, (MSTATUSVal & 0xffffe7ff) | (PrevMode << 11));
 
-      } else {
-        assert(false && "Non-Machine mode is unimplemented!");
-        return;
-      }
+    } else {
+      assert(false && "Non-Machine mode is unimplemented!");
+      return false;
     }
-    std::string Mnemo = I->getMnemo();
-    Stats.addInst(Mnemo);
-    States.incCYCLE();
-    if (BTypeKinds.count(Mnemo))
-      Stats.addBDistAndReset();
-    else
-      Stats.incrementBDist();
-    DEBUG_ONLY(std::cerr << "Regs after:\n"; dumpGPRegs(); States.dump());
   }
-  DEBUG_ONLY(std::cerr << "finish with:\n"; dumpGPRegs();
-             std::cerr << "stop on no instruction address="
-                       << "0x" << std::hex << PC << "\n";);
-  dumpStats();
+  if (DI.Op == Opcode::FENCE_I) {
+    DC.flush();
+    BC.flush();
+  }
+  Stats.addInst(getOpcodeInfo(DI.Op).Mnemo);
+  States.incCYCLE();
+  if (DI.isBranch())
+    Stats.addBDistAndReset();
+  else
+    Stats.incrementBDist();
+  return true;
 }
@@ -0,0 +1,630 @@
+// Threaded code execution engine of Simulator.
+//
+// The loaded image is translated into an array of (handler, DecodedInst) up
+// front, and each handler jumps to the handler of the next instruction
+// directly. Register values live in a local array during the loop. Rare
+// instructions (csr*, ecall, mret, fence.i, ...), PCs out of the image and
+// MMIO stores leave the loop and go through Simulator::step(), so their
+// semantics are shared with run(). Adjacent pairs matching FusionRules are
+// dispatched once to a fused handler, which retires both instructions.
+#include "Fusion.h"
+#include "Simulator/Simulator.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+// Computed goto is a GNU extension, other compilers dispatch by a switch.
+#if defined(__GNUC__) && !defined(NO_COMPUTED_GOTO)
+#define THREADED_COMPUTED_GOTO 1
+#else
+#define THREADED_COMPUTED_GOTO 0
+#endif
+
+namespace {
+
+struct ThreadedInst {
+  const void *Handler; // label of the handler, unused on switch dispatch.
+  DecodedInst DI;
+  /// set if this and the next instruction run as a pair.
+  FusionKind Fused = FusionKind::NONE;
+};
+
+/// case values of the switch dispatch, fused pairs follow opcodes.
+constexpr unsigned getDispatchIndex(Opcode Op) {
+  return static_cast<unsigned>(Op);
+}
+constexpr unsigned getDispatchIndex(FusionKind Kind) {
+  return NUM_OPCODES + 1 + static_cast<unsigned>(Kind);
+}
+
+/// instructions which are executed in the loop, others go through step().
+bool isThreadable(Opcode Op) {
+  return Op != Opcode::INVALID && !isSystem(Op);
+}
+
+/// branch distances shorter than this are counted locally.
+const unsigned NUM_LOCAL_BDISTS = 256;
+
+} // namespace
+
+void Simulator::runThreaded(std::optional<Address> StartAddress,
+                            std::optional<Address> EndAddress) {
+  if (StartAddress)
+    PC = *StartAddress;
+
+  const void *Labels[NUM_OPCODES + 1];
+  const void *FusedLabels[NUM_FUSIONS];
+#if THREADED_COMPUTED_GOTO
+  for (auto &L : Labels)
+    L = &&Slow;
+#define SET_LABEL(Op) Labels[static_cast<unsigned>(Opcode::Op)] = &&L_##Op
+  SET_LABEL(ADDI);
+  SET_LABEL(SLTI);
+  SET_LABEL(SLTIU);
+  SET_LABEL(XORI);
+  SET_LABEL(ORI);
+  SET_LABEL(ANDI);
+  SET_LABEL(JALR);
+  SET_LABEL(LB);
+  SET_LABEL(LH);
+  SET_LABEL(LW);
+  SET_LABEL(LBU);
+  SET_LABEL(LHU);
+  SET_LABEL(SLLI);
+  SET_LABEL(SRLI);
+  SET_LABEL(SRAI);
+  SET_LABEL(FENCE);
+  SET_LABEL(SB);
+  SET_LABEL(SH);
+  SET_LABEL(SW);
+  SET_LABEL(BEQ);
+  SET_LABEL(BNE);
+  SET_LABEL(BLT);
+  SET_LABEL(BGE);
+  SET_LABEL(BLTU);
+  SET_LABEL(BGEU);
+  SET_LABEL(ADD);
+  SET_LABEL(SUB);
+  SET_LABEL(SLL);
+  SET_LABEL(SLT);
+  SET_LABEL(SLTU);
+  SET_LABEL(XOR);
+  SET_LABEL(SRL);
+  SET_LABEL(SRA);
+  SET_LABEL(OR);
+  SET_LABEL(AND);
+  SET_LABEL(MUL);
+  SET_LABEL(MULH);
+  SET_LABEL(MULHSU);
+  SET_LABEL(MULHU);
+  SET_LABEL(DIV);
+  SET_LABEL(DIVU);
+  SET_LABEL(REM);
+  SET_LABEL(REMU);
+  SET_LABEL(LUI);
+  SET_LABEL(AUIPC);
+  SET_LABEL(JAL);
+#undef SET_LABEL
+#define SET_FUSED_LABEL(Kind)                                                  \
+  FusedLabels[static_cast<unsigned>(FusionKind::Kind)] = &&F_##Kind
+  SET_FUSED_LABEL(LUI_ADDI);
+  SET_FUSED_LABEL(AUIPC_ADDI);
+  SET_FUSED_LABEL(AUIPC_JALR);
+  SET_FUSED_LABEL(SLT_BRANCH);
+#undef SET_FUSED_LABEL
+#else
+  for (auto &L : Labels)
+    L = nullptr;
+  for (auto &L : FusedLabels)
+    L = nullptr;
+#endif
+
+  // Translated image, the last entry is a sentinel for the end of it.
+  const Address Base = Mem.getDRAMBase();
+  const Address NumEntries = CodeSize / sizeof(Word);
+  std::vector<ThreadedInst> Code(NumEntries + 1);
+  auto Translate = [&](Address Idx) {
+    Address Ad = Base + Idx * sizeof(Word);
+    Word Val = Mem.read<Word>(Ad);
+    Opcode Op = decodeOpcode(Val);
+    if (!isThreadable(Op) || (EndAddress && Ad == *EndAddress))
+      Op = Opcode::INVALID;
+    Code[Idx] = {Labels[static_cast<unsigned>(Op)], makeDecodedInst(Op, Val)};
+  };
+  // pair the entry with the next one if they match a rule. The second one
+  // keeps its own handler, so jumps into the middle of a pair just work.
+  auto Fuse = [&](Address Idx) {
+    ThreadedInst &TI = Code[Idx];
+    TI.Fused = matchFusion(TI.DI, Code[Idx + 1].DI);
+    TI.Handler = TI.Fused == FusionKind::NONE
+                     ? Labels[static_cast<unsigned>(TI.DI.Op)]
+                     : FusedLabels[static_cast<unsigned>(TI.Fused)];
+  };
+  auto TranslateAll = [&]() {
+    for (Address Idx = 0; Idx < NumEntries; ++Idx)
+      Translate(Idx);
+    for (Address Idx = 0; Idx < NumEntries; ++Idx)
+      Fuse(Idx);
+  };
+  // retranslate the entries overwritten by a store, and refuse the pairs
+  // around them.
+  auto Retranslate = [&](Address Ad, unsigned Size) {
+    Address Begin = (Ad - Base) / sizeof(Word);
+    Address End = std::min<Address>((Ad - Base + Size - 1) / sizeof(Word) + 1,
+                                    NumEntries);
+    for (Address Idx = Begin; Idx < End; ++Idx)
+      Translate(Idx);
+    for (Address Idx = Begin ? Begin - 1 : 0; Idx < End; ++Idx)
+      Fuse(Idx);
+  };
+  Code[NumEntries] = {Labels[NUM_OPCODES],
+                      makeDecodedInst(Opcode::INVALID, 0)};
+  TranslateAll();
+
+  // execute the instruction on PC by step(), returns false to stop. This is
+  // out of the loop body since computed goto doesn't run destructors.
+  auto StepSlow = [&]() {
+    auto I = DC.fetch(PC);
+    if (!I)
+      return false;
+    if (EndAddress && PC == *EndAddress) {
+      std::cerr << "PC reached EndAddress = 0x" << std::hex << *EndAddress
+                << "\n";
+      return false;
+    }
+    if (!step(I->getDecoded()))
+      return false;
+    if (I->getOpcode() == Opcode::FENCE_I)
+      TranslateAll();
+    return true;
+  };
+
+  RegVal R[RegNum];
+  for (unsigned i = 0; i < RegNum; ++i)
+    R[i] = GPRegs[i];
+  Address CurPC = PC;
+  const ThreadedInst *Cur = nullptr;
+
+  // statistics, flushed to Stats and CYCLE on leaving the loop.
+  std::uint64_t Counts[NUM_OPCODES + 1] = {};
+  std::uint64_t BDistCounts[NUM_LOCAL_BDISTS] = {};
+  std::uint64_t FusionCounts[NUM_FUSIONS] = {};
+  std::uint64_t Executed = 0, Synced = 0;
+  unsigned Dist = Stats.getBDist();
+
+#define LOOKUP()                                                               \
+  Cur = (CurPC - Base) / sizeof(Word) < NumEntries && !(CurPC & 0b11)          \
+            ? &Code[(CurPC - Base) / sizeof(Word)]                             \
+            : &Code[NumEntries]
+#define COUNT()                                                                \
+  do {                                                                         \
+    ++Counts[static_cast<unsigned>(Cur->DI.Op)];                               \
+    ++Executed;                                                                \
+  } while (0)
+  // both instructions of a fused pair
+#define COUNT_FUSED()                                                          \
+  do {                                                                         \
+    ++Counts[static_cast<unsigned>(Cur[0].DI.Op)];                             \
+    ++Counts[static_cast<unsigned>(Cur[1].DI.Op)];                             \
+    ++FusionCounts[static_cast<unsigned>(Cur->Fused)];                         \
+    Executed += 2;                                                             \
+  } while (0)
+#if THREADED_COMPUTED_GOTO
+#define HANDLER(Op) L_##Op:
+#define FUSED_HANDLER(Kind) F_##Kind:
+#define DISPATCH() goto *Cur->Handler
+#else
+#define HANDLER(Op) case getDispatchIndex(Opcode::Op):
+#define FUSED_HANDLER(Kind) case getDispatchIndex(FusionKind::Kind):
+#define DISPATCH() goto Dispatch
+#endif
+  // next instruction on PC + 4
+#define NEXT()                                                                 \
+  do {                                                                         \
+    COUNT();                                                                   \
+    ++Dist;                                                                    \
+    CurPC += 4;                                                                \
+    ++Cur;                                                                     \
+    DISPATCH();                                                                \
+  } while (0)
+  // next instruction after a jump to CurPC
+#define JUMP()                                                                 \
+  do {                                                                         \
+    COUNT();                                                                   \
+    ++Dist;                                                                    \
+    LOOKUP();                                                                  \
+    DISPATCH();                                                                \
+  } while (0)
+#define COUNT_BDIST()                                                          \
+  do {                                                                         \
+    if (Dist < NUM_LOCAL_BDISTS)                                               \
+      ++BDistCounts[Dist];                                                     \
+    else                                                                       \
+      Stats.addBDist(Dist);                                                    \
+    Dist = 0;                                                                  \
+  } while (0)
+#define BRANCH(Cond)                                                           \
+  do {                                                                         \
+    COUNT();                                                                   \
+    COUNT_BDIST();                                                             \
+    if (Cond) {                                                                \
+      CurPC += DI.Imm;                                                         \
+      LOOKUP();                                                                \
+    } else {                                                                   \
+      CurPC += 4;                                                              \
+      ++Cur;                                                                   \
+    }                                                                          \
+    DISPATCH();                                                                \
+  } while (0)
+#define WRITE_RD(V)                                                            \
+  do {                                                                         \
+    R[DI.Rd] = (V);                                                            \
+    R[0] = 0;                                                                  \
+  } while (0)
+
+  LOOKUP();
+#if THREADED_COMPUTED_GOTO
+  DISPATCH();
+  {
+#else
+Dispatch:
+  switch (Cur->Fused == FusionKind::NONE ? getDispatchIndex(Cur->DI.Op)
+                                         : getDispatchIndex(Cur->Fused)) {
+  default:
+    goto Slow;
+#endif
+    // I-type
+    HANDLER(ADDI) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((unsigned)R[DI.Rs1] + (unsigned)DI.Imm);
+      NEXT();
+    }
+    HANDLER(SLTI) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((signed)R[DI.Rs1] < DI.Imm);
+      NEXT();
+    }
+    HANDLER(SLTIU) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((unsigned)R[DI.Rs1] < (unsigned)DI.Imm);
+      NEXT();
+    }
+    HANDLER(XORI) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((unsigned)R[DI.Rs1] ^ DI.Imm);
+      NEXT();
+    }
+    HANDLER(ORI) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((unsigned)R[DI.Rs1] | DI.Imm);
+      NEXT();
+    }
+    HANDLER(ANDI) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((unsigned)R[DI.Rs1] & DI.Imm);
+      NEXT();
+    }
+    HANDLER(JALR) {
+      const DecodedInst &DI = Cur->DI;
+      Address RetPC = CurPC + 4;
+      CurPC = (R[DI.Rs1] + DI.Imm) & ~1;
+      WRITE_RD(RetPC);
+      JUMP();
+    }
+    HANDLER(LB) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((signed char)Mem.read<Byte>(R[DI.Rs1] + DI.Imm));
+      NEXT();
+    }
+    HANDLER(LH) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((signed short)Mem.read<HalfWord>(R[DI.Rs1] + DI.Imm));
+      NEXT();
+    }
+    HANDLER(LW) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((signed)Mem.read<Word>(R[DI.Rs1] + DI.Imm));
+      NEXT();
+    }
+    HANDLER(LBU) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((unsigned char)Mem.read<Byte>(R[DI.Rs1] + DI.Imm));
+      NEXT();
+    }
+    HANDLER(LHU) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((unsigned short)Mem.read<HalfWord>(R[DI.Rs1] + DI.Imm));
+      NEXT();
+    }
+    HANDLER(SLLI) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((unsigned)R[DI.Rs1] << (DI.Imm & 0b11111));
+      NEXT();
+    }
+    HANDLER(SRLI) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((unsigned)R[DI.Rs1] >> (DI.Imm & 0b11111));
+      NEXT();
+    }
+    HANDLER(SRAI) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((signed)R[DI.Rs1] >> (DI.Imm & 0b11111));
+      NEXT();
+    }
+    HANDLER(FENCE) { NEXT(); }
+    // S-type, MMIO and stores in epilogue are handled by step().
+#define STORE(T)                                                               \
+  do {                                                                         \
+    const DecodedInst &DI = Cur->DI;                                           \
+    Address Ad = R[DI.Rs1] + DI.Imm;                                           \
+    if ((unsigned)Ad == 0x10000000 || Mode == ModeKind::Epilogue)              \
+      goto Slow;                                                               \
+    Mem.write<T>(Ad, R[DI.Rs2]);                                               \
+    if (Ad - Base < CodeSize)                                                  \
+      Retranslate(Ad, sizeof(T));                                              \
+    NEXT();                                                                    \
+  } while (0)
+    HANDLER(SB) { STORE(Byte); }
+    HANDLER(SH) { STORE(HalfWord); }
+    HANDLER(SW) { STORE(Word); }
+#undef STORE
+    // B-type
+    HANDLER(BEQ) {
+      const DecodedInst &DI = Cur->DI;
+      BRANCH(R[DI.Rs1] == R[DI.Rs2]);
+    }
+    HANDLER(BNE) {
+      const DecodedInst &DI = Cur->DI;
+      BRANCH(R[DI.Rs1] != R[DI.Rs2]);
+    }
+    HANDLER(BLT) {
+      const DecodedInst &DI = Cur->DI;
+      BRANCH(R[DI.Rs1] < R[DI.Rs2]);
+    }
+    HANDLER(BGE) {
+      const DecodedInst &DI = Cur->DI;
+      BRANCH(R[DI.Rs1] >= R[DI.Rs2]);
+    }
+    HANDLER(BLTU) {
+      const DecodedInst &DI = Cur->DI;
+      BRANCH((unsigned)R[DI.Rs1] < (unsigned)R[DI.Rs2]);
+    }
+    HANDLER(BGEU) {
+      const DecodedInst &DI = Cur->DI;
+      BRANCH((unsigned)R[DI.Rs1] >= (unsigned)R[DI.Rs2]);
+    }
+    // R-type
+    HANDLER(ADD) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((unsigned)R[DI.Rs1] + (unsigned)R[DI.Rs2]);
+      NEXT();
+    }
+    HANDLER(SUB) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((unsigned)R[DI.Rs1] - (unsigned)R[DI.Rs2]);
+      NEXT();
+    }
+    HANDLER(SLL) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD(R[DI.Rs1] << (R[DI.Rs2] & 0b11111));
+      NEXT();
+    }
+    HANDLER(SLT) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD(R[DI.Rs1] < R[DI.Rs2]);
+      NEXT();
+    }
+    HANDLER(SLTU) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((unsigned)R[DI.Rs1] < (unsigned)R[DI.Rs2]);
+      NEXT();
+    }
+    HANDLER(XOR) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD(R[DI.Rs1] ^ R[DI.Rs2]);
+      NEXT();
+    }
+    HANDLER(SRL) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((unsigned)R[DI.Rs1] >> (R[DI.Rs2] & 0b11111));
+      NEXT();
+    }
+    HANDLER(SRA) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD((signed)R[DI.Rs1] >> (signed)(R[DI.Rs2] & 0b11111));
+      NEXT();
+    }
+    HANDLER(OR) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD(R[DI.Rs1] | R[DI.Rs2]);
+      NEXT();
+    }
+    HANDLER(AND) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD(R[DI.Rs1] & R[DI.Rs2]);
+      NEXT();
+    }
+    HANDLER(MUL) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD(((signed long long)R[DI.Rs1] * (signed long long)R[DI.Rs2]) &
+               0xffffffff);
+      NEXT();
+    }
+    HANDLER(MULH) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD(((signed long long)R[DI.Rs1] * (signed long long)R[DI.Rs2]) >>
+               32);
+      NEXT();
+    }
+    HANDLER(MULHSU) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD(((signed long long)R[DI.Rs1] *
+                (unsigned long long)(unsigned int)R[DI.Rs2]) >>
+               32);
+      NEXT();
+    }
+    HANDLER(MULHU) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD(((unsigned long long)(unsigned int)R[DI.Rs1] *
+                (unsigned long long)(unsigned int)R[DI.Rs2]) >>
+               32);
+      NEXT();
+    }
+    HANDLER(DIV) {
+      const DecodedInst &DI = Cur->DI;
+      RegVal Divisor = R[DI.Rs2], Dividend = R[DI.Rs1];
+      if (Divisor == 0)
+        WRITE_RD(-1);
+      else if (Dividend == std::numeric_limits<std::int32_t>::min() &&
+               Divisor == -1)
+        WRITE_RD(std::numeric_limits<std::int32_t>::min());
+      else
+        WRITE_RD(Dividend / Divisor);
+      NEXT();
+    }
+    HANDLER(DIVU) {
+      const DecodedInst &DI = Cur->DI;
+      RegVal Divisor = R[DI.Rs2], Dividend = R[DI.Rs1];
+      if (Divisor == 0)
+        WRITE_RD(std::numeric_limits<std::uint32_t>::max());
+      else
+        WRITE_RD((unsigned int)Dividend / (unsigned int)Divisor);
+      NEXT();
+    }
+    HANDLER(REM) {
+      const DecodedInst &DI = Cur->DI;
+      RegVal Divisor = R[DI.Rs2], Dividend = R[DI.Rs1];
+      if (Divisor == 0)
+        WRITE_RD(Dividend);
+      else if (Dividend == std::numeric_limits<std::int32_t>::min() &&
+               Divisor == -1)
+        WRITE_RD(0);
+      else
+        WRITE_RD(Dividend % Divisor);
+      NEXT();
+    }
+    HANDLER(REMU) {
+      const DecodedInst &DI = Cur->DI;
+      RegVal Divisor = R[DI.Rs2], Dividend = R[DI.Rs1];
+      if (Divisor == 0)
+        WRITE_RD(Dividend);
+      else
+        WRITE_RD((unsigned int)Dividend % (unsigned int)Divisor);
+      NEXT();
+    }
+    // U-type
+    HANDLER(LUI) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD(DI.Imm << 12);
+      NEXT();
+    }
+    HANDLER(AUIPC) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD(CurPC + (DI.Imm << 12));
+      NEXT();
+    }
+    // J-type
+    HANDLER(JAL) {
+      const DecodedInst &DI = Cur->DI;
+      WRITE_RD(CurPC + 4);
+      CurPC += DI.Imm;
+      JUMP();
+    }
+    // Fused pairs, DI is the second instruction. Rules guarantee that rd
+    // of the first one isn't x0.
+    FUSED_HANDLER(LUI_ADDI) {
+      const DecodedInst &First = Cur[0].DI, &DI = Cur[1].DI;
+      WRITE_RD((unsigned)(First.Imm << 12) + (unsigned)DI.Imm);
+      COUNT_FUSED();
+      Dist += 2;
+      CurPC += 8;
+      Cur += 2;
+      DISPATCH();
+    }
+    FUSED_HANDLER(AUIPC_ADDI) {
+      const DecodedInst &First = Cur[0].DI, &DI = Cur[1].DI;
+      WRITE_RD(CurPC + (First.Imm << 12) + DI.Imm);
+      COUNT_FUSED();
+      Dist += 2;
+      CurPC += 8;
+      Cur += 2;
+      DISPATCH();
+    }
+    FUSED_HANDLER(AUIPC_JALR) {
+      const DecodedInst &First = Cur[0].DI, &DI = Cur[1].DI;
+      R[First.Rd] = CurPC + (First.Imm << 12);
+      Address RetPC = CurPC + 8;
+      CurPC = (R[DI.Rs1] + DI.Imm) & ~1;
+      WRITE_RD(RetPC);
+      COUNT_FUSED();
+      Dist += 2;
+      LOOKUP();
+      DISPATCH();
+    }
+    FUSED_HANDLER(SLT_BRANCH) {
+      const DecodedInst &First = Cur[0].DI, &DI = Cur[1].DI;
+      bool IsImm = First.Op == Opcode::SLTI || First.Op == Opcode::SLTIU;
+      RegVal Lhs = R[First.Rs1], Rhs = IsImm ? First.Imm : R[First.Rs2];
+      bool Less = First.Op == Opcode::SLT || First.Op == Opcode::SLTI
+                      ? Lhs < Rhs
+                      : (unsigned)Lhs < (unsigned)Rhs;
+      R[First.Rd] = Less;
+      COUNT_FUSED();
+      ++Dist;
+      COUNT_BDIST();
+      // the branch compares rd with x0.
+      if (Less == (DI.Op == Opcode::BNE)) {
+        CurPC += 4 + DI.Imm;
+        LOOKUP();
+      } else {
+        CurPC += 8;
+        Cur += 2;
+      }
+      DISPATCH();
+    }
+  }
+
+Slow: {
+  // write back the local states, and execute one instruction by step().
+  for (unsigned i = 1; i < RegNum; ++i)
+    GPRegs.write(i, R[i]);
+  PC = CurPC;
+  States.write(CYCLE, States.read(CYCLE) + (Executed - Synced));
+  Synced = Executed;
+  Stats.setBDist(Dist);
+
+  if (!StepSlow())
+    goto Exit;
+
+  for (unsigned i = 0; i < RegNum; ++i)
+    R[i] = GPRegs[i];
+  CurPC = PC;
+  Dist = Stats.getBDist();
+  LOOKUP();
+  DISPATCH();
+}
+
+Exit:
+#undef LOOKUP
+#undef COUNT
+#undef COUNT_FUSED
+#undef COUNT_BDIST
+#undef HANDLER
+#undef FUSED_HANDLER
+#undef DISPATCH
+#undef NEXT
+#undef JUMP
+#undef BRANCH
+#undef WRITE_RD
+  for (unsigned i = 0; i < NUM_OPCODES; ++i)
+    if (Counts[i])
+      Stats.addInst(OpcodeInfos[i].Mnemo, Counts[i]);
+  for (unsigned i = 0; i < NUM_LOCAL_BDISTS; ++i)
+    if (BDistCounts[i])
+      Stats.addBDist(i, BDistCounts[i]);
+  for (unsigned i = 0; i < NUM_FUSIONS; ++i)
+    if (FusionCounts[i])
+      Stats.addFusion(getFusionName(static_cast<FusionKind>(i)),
+                      FusionCounts[i]);
+  dumpStats();
+}
@@ -0,0 +1,87 @@
+#include "Simulator/Simulator.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Differential tests of the JIT: every riscv-tests binary runs on run() and
+// runJIT(), and the whole architectural states must be identical.
+
+// FIXME: DRY
+std::vector<std::string> getBinFiles(const std::string &directory,
+                                     const std::string &suffix) {
+  std::vector<std::string> binFiles;
+
+  for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+    std::string fileName = entry.path().filename().string();
+    if (entry.is_regular_file() && fileName.substr(0, 5) == "rv32u" &&
+        fileName.size() > suffix.size() &&
+        fileName.substr(fileName.size() - suffix.size()) == suffix) {
+      binFiles.push_back(entry.path().string());
+    }
+  }
+
+  return binFiles;
+}
+
+void expectSameState(const Simulator &Ref, const Simulator &Sim,
+                     const std::string &FileName) {
+  EXPECT_EQ(Ref.getPC(), Sim.getPC()) << FileName;
+  for (unsigned i = 0; i < RegNum; ++i)
+    EXPECT_EQ(Ref.getGPRegs()[i], Sim.getGPRegs()[i])
+        << FileName << ": x" << i;
+  for (CSRAddress i = 0; i < CSR_SIZE; ++i)
+    EXPECT_EQ(Ref.getCSRs()[i], Sim.getCSRs()[i])
+        << FileName << ": csr 0x" << std::hex << i;
+  const Memory &RefMem = Ref.getMemory(), &Mem = Sim.getMemory();
+  Address End = Mem.getDRAMBase() + Mem.getDRAMSize();
+  for (Address Ad = Mem.getDRAMBase(); Ad < End; Ad += sizeof(Word))
+    ASSERT_EQ(RefMem.read<Word>(Ad), Mem.read<Word>(Ad))
+        << FileName << ": memory 0x" << std::hex << Ad;
+}
+
+// the threshold of compilation, 0 compiles every block on the first visit.
+class JITDiffTest : public ::testing::TestWithParam<
+                        std::tuple<std::string, unsigned>> {};
+class ExtendedJITDiffTest : public ::testing::TestWithParam<
+                                std::tuple<std::string, unsigned>> {};
+
+TEST_P(JITDiffTest, RiscvTests) {
+  auto [FileName, Threshold] = GetParam();
+  auto RefFiles = std::ifstream(FileName);
+  Simulator Ref(RefFiles, /* DRAMSize = */ 1 << 15, /*DRAMBase = */ 0x0000);
+  Ref.run(/*StartAddress = */ 0x0000, /*EndAddress = */ 0x0000 + 0x4c);
+  auto Files = std::ifstream(FileName);
+  Simulator Sim(Files, /* DRAMSize = */ 1 << 15, /*DRAMBase = */ 0x0000);
+  Sim.setJITThreshold(Threshold);
+  Sim.runJIT(/*StartAddress = */ 0x0000, /*EndAddress = */ 0x0000 + 0x4c);
+  EXPECT_EQ(Sim.getGPRegs()[3], 1) << FileName << " failed\n";
+  expectSameState(Ref, Sim, FileName);
+}
+
+TEST_P(ExtendedJITDiffTest, ExtendedRiscvTests) {
+  auto [FileName, Threshold] = GetParam();
+  auto RefFiles = std::ifstream(FileName);
+  Simulator Ref(RefFiles, /* DRAMSize = */ 1 << 15, /*DRAMBase = */ 0x0000);
+  Ref.run();
+  auto Files = std::ifstream(FileName);
+  Simulator Sim(Files, /* DRAMSize = */ 1 << 15, /*DRAMBase = */ 0x0000);
+  Sim.setJITThreshold(Threshold);
+  Sim.runJIT();
+  EXPECT_EQ(Sim.getGPRegs()[3], 1) << FileName << " failed\n";
+  expectSameState(Ref, Sim, FileName);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    RV32IM, JITDiffTest,
+    ::testing::Combine(::testing::ValuesIn(getBinFiles("../rip-tests",
+                                                       ".bin")),
+                       ::testing::Values(0, 2)));
+
+INSTANTIATE_TEST_SUITE_P(
+    RV32IM, ExtendedJITDiffTest,
+    ::testing::Combine(::testing::ValuesIn(getBinFiles("../rip-tests",
+                                                       ".bin.rip")),
+                       ::testing::Values(0, 2)));
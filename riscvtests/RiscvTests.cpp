@@ -50,6 +50,26 @@ TEST_P(RiscvTests, RiscvTests) {
   EXPECT_EQ(Res[3], 1) << FileName << " failed\n";
 }
 
+TEST_P(RiscvTests, ThreadedRiscvTests) {
+  std::string FileName = GetParam();
+  auto Files = std::ifstream(FileName);
+  Simulator Sim(Files, /* DRAMSize = */ 1 << 15, /*DRAMBase = */ 0x0000);
+  Sim.runThreaded(/*StartAddress = */ 0x0000,
+                  /*EndAddress = */ 0x0000 + 0x4c);
+  const GPRegisters &Res = Sim.getGPRegs();
+  EXPECT_EQ(Res[3], 1) << FileName << " failed\n";
+}
+
+TEST_P(RiscvTests, BlockRiscvTests) {
+  std::string FileName = GetParam();
+  auto Files = std::ifstream(FileName);
+  Simulator Sim(Files, /* DRAMSize = */ 1 << 15, /*DRAMBase = */ 0x0000);
+  Sim.runBlocks(/*StartAddress = */ 0x0000,
+                /*EndAddress = */ 0x0000 + 0x4c);
+  const GPRegisters &Res = Sim.getGPRegs();
+  EXPECT_EQ(Res[3], 1) << FileName << " failed\n";
+}
+
 TEST_P(ExtendedRiscvTests, ExtendedRiscvTests) {
   std::string FileName = GetParam();
   auto Files = std::ifstream(FileName);
@@ -45,6 +45,9 @@ private:
   // statistics dump
   Address DRAMSize;
 
+  // backing store of DRAM
+  MemoryKind MemKind;
+
   // address where program starts.
   std::optional<Address> StartAddress;
 
@@ -54,7 +57,8 @@ private:
 public:
   Options()
       : BPKind(No), Interactive(false), Statistics(false), DRAMSize(1 << 28),
-        StartAddress(std::nullopt), EndAddress(std::nullopt) {}
+        MemKind(MemoryKind::Paged), StartAddress(std::nullopt),
+        EndAddress(std::nullopt) {}
 
   // return true if succeed.
   bool parse(int argc, char **argv) {
@@ -81,6 +85,17 @@ public:
         Interactive = true;
       } else if (arg.substr(0, 12) == "--dram-size=") {
         DRAMSize = std::stoll(arg.substr(12));
+      } else if (arg.substr(0, 9) == "--memory=") {
+        std::string MemStr = arg.substr(9);
+        if (MemStr == "flat") {
+          MemKind = MemoryKind::Flat;
+        } else if (MemStr == "paged") {
+          MemKind = MemoryKind::Paged;
+        } else {
+          std::cerr << "Invalid option for --memory. Allowed options: flat "
+                       "and paged.\n";
+          return false;
+        }
       } else if (arg.substr(0, 18) == "--start-address=0x") {
         StartAddress = std::stoll(arg.substr(18), nullptr, 16);
       } else if (arg.substr(0, 16) == "--end-address=0x") {
@@ -102,10 +117,13 @@ public:
         << "Usage: rip-sim"
         << " <baremetal binary file name> "
            "-b=<no/onebit/twobit/gshare/interactive> [--dram-size=N] "
-           "[--stats]\n"
+           "[--memory=<flat/paged>] [--stats]\n"
         << "-b=<option> : Set branch prediction type (no, onebit, twobit, "
            "gshare and interactive)\n"
         << "--dram-size=N : Set DRAM size in kilobytes (N)\n"
+        << "--memory=<option> : Set DRAM backing store, flat allocates whole "
+           "DRAM on startup and paged allocates 4KiB pages on first touch "
+           "(default: paged)\n"
         << "--stats : print statistics\n"
         << "-i : Additional flag\n";
   }
@@ -123,6 +141,8 @@ public:
 
   inline const Address &getDRAMSize() { return DRAMSize; }
 
+  inline const MemoryKind &getMemoryKind() { return MemKind; }
+
   inline const std::optional<Address> &getStartAddress() {
     return StartAddress;
   }
@@ -164,7 +184,7 @@ int main(int argc, char **argv) {
 
   RIPSimulator RipSim(Files, std::move(BP), Ops.getDRAMSize(), std::move(Stats),
                       /*DRAMBase = */ 0x0000,
-                      /*SPIValue = */ 1 << 25);
+                      /*SPIValue = */ 1 << 25, Ops.getMemoryKind());
 
   if (Ops.getInteractive())
     RipSim.runInteractively(Ops.getStartAddress(), Ops.getEndAddress());
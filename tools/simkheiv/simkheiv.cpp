@@ -1,23 +1,52 @@
 #include <Simulator/Simulator.h>
 #include <cassert>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 
 int main(int argc, char **argv) {
-  if (argc < 2) {
-    std::cerr << "Usage: " << argv[0] << " <baremetal binary file name>"
+  std::string FileName;
+  bool Threaded = false, Blocks = false, JIT = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string Arg = argv[i];
+    if (Arg == "--threaded")
+      Threaded = true;
+    else if (Arg == "--blocks")
+      Blocks = true;
+    else if (Arg == "--jit")
+      JIT = true;
+    else if (!Arg.empty() && Arg[0] != '-')
+      FileName = Arg;
+  }
+  if (FileName.empty()) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--threaded|--blocks|--jit] <baremetal binary file name>"
               << "\n";
     return 1;
   }
-  const std::string FileName = argv[1];
   std::string BaseNoExt = FileName.substr(0, FileName.find_last_of('.'));
   auto Files = std::ifstream(FileName);
   Simulator Sim(Files, /*DRAMSize = */ 1LL << 28,
                 /* DRAMBase = */ 0x0000,
-                /* SPIvalue = */ 1LL << 25);
-  Sim.run();
+                /* SPIvalue = */ 1LL << 25,
+                /* MemKind = */ MemoryKind::Paged);
+  auto Start = std::chrono::steady_clock::now();
+  if (Threaded)
+    Sim.runThreaded();
+  else if (Blocks)
+    Sim.runBlocks();
+  else if (JIT)
+    Sim.runJIT();
+  else
+    Sim.run();
+  std::chrono::duration<double> Elapsed =
+      std::chrono::steady_clock::now() - Start;
   Sim.dumpGPRegs();
   Sim.getCSRs().dump();
 
+  auto Executed = Sim.getCSRs()[CYCLE];
+  std::cerr << std::dec << "Executed " << Executed << " instructions in "
+            << Elapsed.count() << " s ("
+            << Executed / Elapsed.count() / 1e6 << " MIPS)\n";
   return 0;
 }
@@ -0,0 +1,119 @@
+#include "BlockCache.h"
+#include <gtest/gtest.h>
+
+const Address DRAM_BASE = 0x8000;
+
+TEST(BlockCacheTest, Formation) {
+  Memory Mem(1 << 16, DRAM_BASE, MemoryKind::Paged);
+  BlockCache BC(Mem);
+  Mem.writeWord(DRAM_BASE, 0x00500813);      // addi x16, x0, 5
+  Mem.writeWord(DRAM_BASE + 4, 0x00300893);  // addi x17, x0, 3
+  Mem.writeWord(DRAM_BASE + 8, 0xff180ce3);  // beq x16, x17, -8
+  Mem.writeWord(DRAM_BASE + 12, 0x30200073); // mret
+  Mem.writeWord(DRAM_BASE + 16, 0x00500813); // addi x16, x0, 5
+
+  BasicBlock *B = BC.lookup(DRAM_BASE);
+  ASSERT_NE(B, nullptr);
+  EXPECT_EQ(B->EntryPC, DRAM_BASE);
+  ASSERT_EQ(B->Insts.size(), 3);
+  EXPECT_EQ(B->Insts.back().Op, Opcode::BEQ);
+  EXPECT_EQ(B->Succs[0].PC, DRAM_BASE + 12);
+  EXPECT_EQ(B->Succs[1].PC, DRAM_BASE);
+  EXPECT_EQ(BC.lookup(DRAM_BASE), B);
+  EXPECT_EQ(BC.getMisses(), 1);
+  EXPECT_EQ(BC.getHits(), 1);
+
+  // system instructions end a block by themselves.
+  BasicBlock *Ret = BC.lookup(DRAM_BASE + 12);
+  ASSERT_EQ(Ret->Insts.size(), 1);
+  EXPECT_EQ(Ret->Insts[0].Op, Opcode::MRET);
+
+  // a block in the middle of another one is a block of its own.
+  EXPECT_EQ(BC.lookup(DRAM_BASE + 4)->Insts.size(), 2);
+
+  // blocks end before an undecodable word, and it isn't cached.
+  EXPECT_EQ(BC.lookup(DRAM_BASE + 16)->Insts.size(), 1);
+  EXPECT_EQ(BC.lookup(DRAM_BASE + 20), nullptr);
+  EXPECT_EQ(BC.lookup(DRAM_BASE + 2), nullptr);
+}
+
+TEST(BlockCacheTest, Split) {
+  Memory Mem(1 << 16, DRAM_BASE, MemoryKind::Flat);
+  BlockCache BC(Mem);
+  for (Address Ad = DRAM_BASE; Ad < DRAM_BASE + 3 * Memory::PageSize; Ad += 4)
+    Mem.writeWord(Ad, 0x00000013); // nop
+
+  EXPECT_EQ(BC.lookup(DRAM_BASE)->Insts.size(), BlockCache::MaxBlockInsts);
+  // blocks don't cross pages.
+  Address Last = DRAM_BASE + Memory::PageSize - 8;
+  EXPECT_EQ(BC.lookup(Last)->Insts.size(), 2);
+  EXPECT_EQ(BC.lookup(Last)->Succs[0].PC, DRAM_BASE + Memory::PageSize);
+
+  // and stop before the stop address.
+  BC.setStopAddress(DRAM_BASE + 16);
+  EXPECT_EQ(BC.lookup(DRAM_BASE)->Insts.size(), 4);
+  EXPECT_EQ(BC.lookup(DRAM_BASE + 16)->Insts.size(),
+            BlockCache::MaxBlockInsts);
+}
+
+TEST(BlockCacheTest, Chaining) {
+  Memory Mem(1 << 16, DRAM_BASE, MemoryKind::Flat);
+  BlockCache BC(Mem);
+  Mem.writeWord(DRAM_BASE, 0x00500813);     // addi x16, x0, 5
+  Mem.writeWord(DRAM_BASE + 4, 0xfe081ee3); // bne x16, x0, -4
+  Mem.writeWord(DRAM_BASE + 8, 0x00300893); // addi x17, x0, 3
+
+  BasicBlock *B = BC.lookup(DRAM_BASE);
+  BasicBlock *Loop = BC.next(B, DRAM_BASE + 8);
+  EXPECT_EQ(BC.getChained(), 0);
+  EXPECT_EQ(BC.next(B, DRAM_BASE + 8), Loop);
+  EXPECT_EQ(BC.getChained(), 1);
+  // the loop back edge links the block to itself.
+  EXPECT_EQ(BC.next(B, DRAM_BASE), B);
+  EXPECT_EQ(BC.next(B, DRAM_BASE), B);
+  EXPECT_EQ(BC.getChained(), 2);
+
+  // unrelated targets are looked up.
+  BC.next(B, DRAM_BASE + 4);
+  EXPECT_EQ(BC.getChained(), 2);
+}
+
+TEST(BlockCacheTest, InvalidateOnStore) {
+  Memory Mem(1 << 16, DRAM_BASE, MemoryKind::Flat);
+  BlockCache BC(Mem);
+  Mem.writeWord(DRAM_BASE, 0x00500813);      // addi x16, x0, 5
+  Mem.writeWord(DRAM_BASE + 4, 0x00300893);  // addi x17, x0, 3
+  Mem.writeWord(DRAM_BASE + 8, 0xff180ce3);  // beq x16, x17, -8
+  Mem.writeWord(DRAM_BASE + 12, 0x00300893); // addi x17, x0, 3
+
+  BasicBlock *Old = BC.lookup(DRAM_BASE);
+  BasicBlock *Next = BC.lookup(DRAM_BASE + 12);
+  EXPECT_EQ(BC.next(Old, DRAM_BASE + 12), Next);
+  Old->ExecCount = 2;
+
+  // overwrite with slti x17, x16, -2
+  Mem.writeWord(DRAM_BASE + 4, 0xffe82893);
+  // the old block is kept alive until collect().
+  EXPECT_FALSE(Old->Valid);
+  EXPECT_EQ(Old->Insts[1].Op, Opcode::ADDI);
+  EXPECT_TRUE(Next->Valid);
+  BasicBlock *New = BC.lookup(DRAM_BASE);
+  EXPECT_EQ(New->Insts[1].Op, Opcode::SLTI);
+  // links made before the store aren't followed.
+  std::uint64_t Chained = BC.getChained();
+  EXPECT_EQ(BC.next(Old, DRAM_BASE + 12), Next);
+  EXPECT_EQ(BC.getChained(), Chained);
+  BC.collect();
+
+  New->ExecCount = 3;
+  Next->ExecCount = 1;
+  auto Counts = BC.getBlockCounts();
+  EXPECT_EQ(Counts[DRAM_BASE], 5);
+  EXPECT_EQ(Counts[DRAM_BASE + 12], 1);
+
+  BC.flush();
+  EXPECT_FALSE(New->Valid);
+  EXPECT_NE(BC.lookup(DRAM_BASE), nullptr);
+  BC.collect();
+  EXPECT_EQ(BC.getBlockCounts()[DRAM_BASE], 5);
+}
@@ -0,0 +1,61 @@
+#include "DecodeCache.h"
+#include <gtest/gtest.h>
+
+const Address DRAM_BASE = 0x8000;
+
+TEST(DecodeCacheTest, HitAndMiss) {
+  Memory Mem(1 << 16, DRAM_BASE, MemoryKind::Paged);
+  Decoder Dec;
+  DecodeCache DC(Mem, Dec);
+  Mem.writeWord(DRAM_BASE, 0x00500813); // addi x16, x0, 5
+
+  auto First = DC.fetch(DRAM_BASE);
+  ASSERT_NE(First, nullptr);
+  EXPECT_EQ(First->getMnemo(), "addi");
+  EXPECT_EQ(DC.getMisses(), 1);
+  EXPECT_EQ(DC.getHits(), 0);
+
+  auto Second = DC.fetch(DRAM_BASE);
+  EXPECT_EQ(First, Second);
+  EXPECT_EQ(DC.getMisses(), 1);
+  EXPECT_EQ(DC.getHits(), 1);
+
+  // the end of program isn't cached.
+  EXPECT_EQ(DC.fetch(DRAM_BASE + 4), nullptr);
+  EXPECT_EQ(DC.fetch(DRAM_BASE + 4), nullptr);
+  EXPECT_EQ(DC.getMisses(), 3);
+}
+
+TEST(DecodeCacheTest, InvalidateOnStore) {
+  Memory Mem(1 << 16, DRAM_BASE, MemoryKind::Flat);
+  Decoder Dec;
+  DecodeCache DC(Mem, Dec);
+  Mem.writeWord(DRAM_BASE, 0x00500813);     // addi x16, x0, 5
+  Mem.writeWord(DRAM_BASE + 4, 0x00300893); // addi x17, x0, 3
+
+  auto Old = DC.fetch(DRAM_BASE);
+  DC.fetch(DRAM_BASE + 4);
+
+  // overwrite with slti x17, x16, -2
+  Mem.writeWord(DRAM_BASE, 0xffe82893);
+  auto New = DC.fetch(DRAM_BASE);
+  EXPECT_EQ(New->getMnemo(), "slti");
+  // in-flight instruction is kept alive.
+  EXPECT_EQ(Old->getMnemo(), "addi");
+  EXPECT_EQ(DC.getMisses(), 3);
+
+  // neighbours are not affected.
+  DC.fetch(DRAM_BASE + 4);
+  EXPECT_EQ(DC.getHits(), 1);
+
+  // partial store invalidates the word.
+  Mem.writeByte(DRAM_BASE + 7, 0);
+  DC.fetch(DRAM_BASE + 4);
+  EXPECT_EQ(DC.getMisses(), 4);
+
+  DC.flush();
+  DC.fetch(DRAM_BASE);
+  DC.fetch(DRAM_BASE + 4);
+  EXPECT_EQ(DC.getMisses(), 6);
+  EXPECT_EQ(DC.getHits(), 1);
+}
@@ -253,3 +253,99 @@ TEST(DecoderTest, CSRRW) {
   EXPECT_EQ(InstPtr->getRs1(), 0);
   EXPECT_EQ(InstPtr->getVal(), InstVal);
 }
+
+TEST(DecoderTest, Opcode) {
+  Decoder Dec;
+  // beq x16, x17, 12
+  auto InstPtr = Dec.decode(0x01180663);
+  EXPECT_EQ(InstPtr->getOpcode(), Opcode::BEQ);
+  EXPECT_EQ(InstPtr->getFormat(), InstFormat::B);
+  EXPECT_TRUE(isBranch(InstPtr->getOpcode()));
+  EXPECT_FALSE(InstPtr->hasRd());
+
+  // csrrsi x0, mstatus, 8
+  InstPtr = Dec.decode(0x30046073);
+  EXPECT_EQ(InstPtr->getOpcode(), Opcode::CSRRSI);
+  EXPECT_TRUE(isCSR(InstPtr->getOpcode()));
+  EXPECT_TRUE(isCSRImm(InstPtr->getOpcode()));
+
+  // fence.i
+  InstPtr = Dec.decode(0x0000100f);
+  EXPECT_EQ(InstPtr->getOpcode(), Opcode::FENCE_I);
+}
+
+TEST(DecoderTest, OpcodeInfosMatchKinds) {
+  for (const auto &[Mnemo, _] : ITypeKinds)
+    EXPECT_EQ(getFormat(findOpcode(Mnemo)), InstFormat::I) << Mnemo;
+  for (const auto &[Mnemo, _] : STypeKinds)
+    EXPECT_TRUE(isStore(findOpcode(Mnemo))) << Mnemo;
+  for (const auto &[Mnemo, _] : BTypeKinds)
+    EXPECT_TRUE(isBranch(findOpcode(Mnemo))) << Mnemo;
+  for (const auto &[Mnemo, _] : RTypeKinds)
+    EXPECT_EQ(getFormat(findOpcode(Mnemo)), InstFormat::R) << Mnemo;
+  for (const auto &[Mnemo, _] : UTypeKinds)
+    EXPECT_EQ(getFormat(findOpcode(Mnemo)), InstFormat::U) << Mnemo;
+  for (const auto &[Mnemo, _] : JTypeKinds)
+    EXPECT_EQ(getFormat(findOpcode(Mnemo)), InstFormat::J) << Mnemo;
+  EXPECT_EQ(ITypeKinds.size() + STypeKinds.size() + BTypeKinds.size() +
+                RTypeKinds.size() + UTypeKinds.size() + JTypeKinds.size(),
+            NUM_OPCODES);
+}
+
+TEST(DecoderTest, DecodedInst) {
+  Decoder Dec;
+  // beq x0, x0, -4
+  DecodedInst DI = Dec.decode(0xfe000ee3)->getDecoded();
+  EXPECT_EQ(DI.Op, Opcode::BEQ);
+  EXPECT_TRUE(DI.isBranch());
+  EXPECT_EQ(DI.Imm, -4);
+
+  // jal x1, -8
+  DI = Dec.decode(0xff9ff0ef)->getDecoded();
+  EXPECT_EQ(DI.Op, Opcode::JAL);
+  EXPECT_EQ(DI.Rd, 1);
+  EXPECT_EQ(DI.Imm, -8);
+
+  // sw x2, -12(x3)
+  DI = Dec.decode(0xfe21aa23)->getDecoded();
+  EXPECT_TRUE(DI.isStore());
+  EXPECT_EQ(DI.Rs1, 3);
+  EXPECT_EQ(DI.Rs2, 2);
+  EXPECT_EQ(DI.Imm, -12);
+
+  // addi x1, x0, -1
+  DI = Dec.decode(0xfff00093)->getDecoded();
+  EXPECT_EQ(DI.Imm, -1);
+
+  // lui x5, 0xfffff
+  DI = Dec.decode(0xfffff2b7)->getDecoded();
+  EXPECT_EQ(DI.Rd, 5);
+  EXPECT_EQ(DI.Imm, -1);
+
+  // csrrw x1, mtvec, x2
+  DI = Dec.decode(0x305110f3)->getDecoded();
+  EXPECT_TRUE(DI.isCSR());
+  EXPECT_EQ(DI.getCSRAddr(), 0x305u);
+}
+
+TEST(DecoderTest, DecodeTable) {
+  Decoder Dec;
+  for (unsigned i = 0; i < NUM_OPCODES; ++i) {
+    const OpcodeInfo &Info = OpcodeInfos[i];
+    // don't care bits must not change the result.
+    for (Word Other : {0u, 0xffffffffu, 0x5a5a5a5au}) {
+      Word Val = Info.Match | (Other & ~Info.Mask);
+      EXPECT_EQ(decodeOpcode(Val), static_cast<Opcode>(i)) << Info.Mnemo;
+      auto InstPtr = Dec.decode(Val);
+      ASSERT_TRUE(InstPtr) << Info.Mnemo;
+      EXPECT_EQ(InstPtr->getOpcode(), static_cast<Opcode>(i)) << Info.Mnemo;
+    }
+  }
+
+  EXPECT_EQ(decodeOpcode(0x00000000), Opcode::INVALID);
+  EXPECT_EQ(decodeOpcode(0xffffffff), Opcode::INVALID);
+  // srli with funct7 other than 0 nor 0b0100000.
+  EXPECT_EQ(decodeOpcode(0x02005013), Opcode::INVALID);
+  // branch with funct3 = 0b010
+  EXPECT_EQ(Dec.decode(0x00002063), nullptr);
+}
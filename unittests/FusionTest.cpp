@@ -0,0 +1,53 @@
+#include "Fusion.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+DecodedInst decode(Word Val) {
+  return makeDecodedInst(decodeOpcode(Val), Val);
+}
+
+} // namespace
+
+TEST(FusionTest, LuiAddi) {
+  DecodedInst Lui = decode(0x000125b7);  // lui x11, 0x12
+  DecodedInst Addi = decode(0x34558593); // addi x11, x11, 0x345
+  EXPECT_EQ(matchFusion(Lui, Addi), FusionKind::LUI_ADDI);
+  // the addi must consume and overwrite rd of the lui.
+  EXPECT_EQ(matchFusion(Lui, decode(0x34550593)), // addi x11, x10, 0x345
+            FusionKind::NONE);
+  EXPECT_EQ(matchFusion(Lui, decode(0x34558613)), // addi x12, x11, 0x345
+            FusionKind::NONE);
+  EXPECT_EQ(matchFusion(Addi, Lui), FusionKind::NONE);
+  EXPECT_STREQ(getFusionName(FusionKind::LUI_ADDI), "lui+addi");
+}
+
+TEST(FusionTest, Auipc) {
+  DecodedInst Auipc = decode(0x00000317); // auipc x6, 0
+  EXPECT_EQ(matchFusion(Auipc, decode(0x010300e7)), // jalr x1, 16(x6)
+            FusionKind::AUIPC_JALR);
+  EXPECT_EQ(matchFusion(Auipc, decode(0x01030313)), // addi x6, x6, 16
+            FusionKind::AUIPC_ADDI);
+  EXPECT_EQ(matchFusion(Auipc, decode(0x010080e7)), // jalr x1, 16(x1)
+            FusionKind::NONE);
+  // writes to x0 are dropped, so nothing is passed to the second one.
+  EXPECT_EQ(matchFusion(decode(0x00000017),  // auipc x0, 0
+                        decode(0x010000e7)), // jalr x1, 16(x0)
+            FusionKind::NONE);
+}
+
+TEST(FusionTest, SltBranch) {
+  DecodedInst Slt = decode(0x00c5a533); // slt x10, x11, x12
+  EXPECT_EQ(matchFusion(Slt, decode(0x00051463)), // bne x10, x0, 8
+            FusionKind::SLT_BRANCH);
+  EXPECT_EQ(matchFusion(Slt, decode(0x00a00463)), // beq x0, x10, 8
+            FusionKind::SLT_BRANCH);
+  EXPECT_EQ(matchFusion(decode(0x0055b513),  // sltiu x10, x11, 5
+                        decode(0x00050463)), // beq x10, x0, 8
+            FusionKind::SLT_BRANCH);
+  // only comparisons with x0 are fused.
+  EXPECT_EQ(matchFusion(Slt, decode(0x00b51463)), // bne x10, x11, 8
+            FusionKind::NONE);
+  EXPECT_EQ(matchFusion(Slt, decode(0x00054463)), // blt x10, x0, 8
+            FusionKind::NONE);
+}
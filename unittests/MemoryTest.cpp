@@ -0,0 +1,59 @@
+#include "Memory.h"
+#include <gtest/gtest.h>
+
+const Address DRAM_BASE = 0x8000;
+
+TEST(MemoryTest, PagedMatchesFlat) {
+  Memory Flat(1 << 16, DRAM_BASE, MemoryKind::Flat);
+  Memory Paged(1 << 16, DRAM_BASE, MemoryKind::Paged);
+
+  for (Memory *M : {&Flat, &Paged}) {
+    M->writeWord(DRAM_BASE + 0x10, 0xdeadbeef);
+    M->writeHalfWord(DRAM_BASE + 0x22, 0xcafe);
+    M->writeByte(DRAM_BASE + 0x31, 0x7f);
+    // crosses the page boundary
+    M->writeWord(DRAM_BASE + Memory::PageSize - 2, 0x01234567);
+  }
+
+  for (Address Ad = DRAM_BASE; Ad < DRAM_BASE + 2 * Memory::PageSize; ++Ad)
+    EXPECT_EQ(Flat.readByte(Ad), Paged.readByte(Ad)) << "Address: " << Ad;
+
+  EXPECT_EQ(Paged.readWord(DRAM_BASE + 0x10), 0xdeadbeef);
+  EXPECT_EQ(Paged.readHalfWord(DRAM_BASE + 0x22), 0xcafe);
+  EXPECT_EQ(Paged.readByte(DRAM_BASE + 0x31), 0x7f);
+  EXPECT_EQ(Paged.readWord(DRAM_BASE + Memory::PageSize - 2), 0x01234567);
+}
+
+TEST(MemoryTest, PagedAllocatesOnFirstWrite) {
+  Memory Paged(1LL << 28, 0x0000, MemoryKind::Paged);
+  EXPECT_EQ(Paged.getResidentSize(), 0);
+
+  // untouched pages read as zero without being allocated.
+  EXPECT_EQ(Paged.readWord(0x1000), 0);
+  EXPECT_EQ(Paged.readWord((1LL << 28) - 4), 0);
+  EXPECT_EQ(Paged.getResidentSize(), 0);
+
+  Paged.writeWord(0x1000, 1);
+  EXPECT_EQ(Paged.getResidentSize(), Memory::PageSize);
+
+  Paged.writeHalfWord(0x3fff, 0xffff);
+  EXPECT_EQ(Paged.getResidentSize(), 3 * Memory::PageSize);
+
+  Memory Flat(1 << 16, 0x0000, MemoryKind::Flat);
+  EXPECT_EQ(Flat.getResidentSize(), 1 << 16);
+}
+
+TEST(MemoryTest, MisalignedAccess) {
+  for (MemoryKind Kind : {MemoryKind::Flat, MemoryKind::Paged}) {
+    Memory M(1 << 16, DRAM_BASE, Kind);
+    M.writeWord(DRAM_BASE + 0x101, 0x89abcdef);
+    EXPECT_EQ(M.readByte(DRAM_BASE + 0x101), 0xef);
+    EXPECT_EQ(M.readByte(DRAM_BASE + 0x104), 0x89);
+    EXPECT_EQ(M.readHalfWord(DRAM_BASE + 0x103), 0x89ab);
+    EXPECT_EQ(M.readWord(DRAM_BASE + 0x101), 0x89abcdef);
+    EXPECT_EQ(M.readWord(DRAM_BASE + 0x100), 0xabcdef00);
+
+    M.writeHalfWord(DRAM_BASE + 0x201, 0x1234);
+    EXPECT_EQ(M.readWord(DRAM_BASE + 0x200), 0x00123400);
+  }
+}
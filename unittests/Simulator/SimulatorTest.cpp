@@ -351,6 +351,30 @@ TEST(SimulatorTest, SWLW) {
   }
 }
 
+TEST(SimulatorTest, SWLW_PAGED) {
+  const unsigned char BYTES[] = {
+      0x13, 0x08, 0x00, 0x80, // addi x16, x0, -2048
+      0x93, 0x08, 0x30, 0x00, // addi x17, x0, 3
+      0x23, 0x2e, 0x01, 0xff, // sw x16, -4(sp)
+      0x03, 0x29, 0xc1, 0xff, // lw x18, -4(sp)
+  };
+
+  const GPRegisters EXPECTED = {{16, -2048}, {17, 3}, {18, -2048}};
+  std::stringstream ss;
+  ss.write(reinterpret_cast<const char *>(BYTES), sizeof(BYTES));
+
+  Simulator Sim(ss, /*DRAMSize = */ 1 << 10, /*DRAMBase = */ DRAM_BASE,
+                /*SPIValue = */ std::nullopt, MemoryKind::Paged);
+  Sim.run();
+  const GPRegisters &Res = Sim.getGPRegs();
+
+  for (unsigned i = 0; i < 32; ++i) {
+    EXPECT_EQ(Res[i], EXPECTED[i])
+        << "Register:" << i << ", expected: " << EXPECTED[i]
+        << ", got: " << Res[i];
+  }
+}
+
 TEST(SimulatorTest, SHLHLHU) {
   const unsigned char BYTES[] = {
       0x13, 0x08, 0x00, 0x80, // addi x16, x0, -2048
@@ -1031,4 +1055,23 @@ TEST(SimulatorTest, MRET) {
   EXPECT_EQ(Sim.getPC(), EXPECTED_PC)
       << "PC"
       << ", expected: " << EXPECTED_PC << ", got: " << Sim.getPC();
-}
\ No newline at end of file
+}
+TEST(SimulatorTest, DECODE_CACHE) {
+  const unsigned char BYTES[] = {
+      0x13, 0x08, 0xa0, 0x00, // addi x16, x0, 10
+      0x13, 0x08, 0xf8, 0xff, // addi x16, x16, -1
+      0xe3, 0x1e, 0x08, 0xfe, // bne x16, x0, -4
+  };
+
+  std::stringstream ss;
+  ss.write(reinterpret_cast<const char *>(BYTES), sizeof(BYTES));
+
+  Simulator Sim(ss);
+  Sim.run();
+  EXPECT_EQ(Sim.getGPRegs()[16], 0);
+
+  // each static instruction and the end of program are decoded once.
+  const Statistics &Stats = Sim.getStats();
+  EXPECT_EQ(Stats.getDecodeCacheMisses(), 4);
+  EXPECT_EQ(Stats.getDecodeCacheHits(), 18);
+}